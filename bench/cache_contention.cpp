@@ -0,0 +1,95 @@
+#include <iris/gfx/cache.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace ir {
+    struct bench_cached_t {
+        using cache_key_type = uint64;
+        using cache_value_type = uint64;
+
+        constexpr static auto max_ttl = 8_u32;
+        constexpr static auto is_persistent = false;
+    };
+
+    constexpr static auto operations = 1'000'000_u64;
+    // small enough to stay resident, every thread mostly hits like a warm descriptor or sampler cache
+    constexpr static auto key_count = 4096_u64;
+
+    // the baseline, one mutex in front of a single cache
+    class locked_cache_t {
+    public:
+        using self = locked_cache_t;
+
+        locked_cache_t() noexcept = default;
+        ~locked_cache_t() noexcept = default;
+
+        IR_DELETE_COPY(locked_cache_t);
+        IR_DELETE_MOVE(locked_cache_t);
+
+        IR_NODISCARD auto try_acquire(uint64 key) noexcept -> std::optional<uint64> {
+            auto lock = std::lock_guard(_lock);
+            if (auto* value = _cache.try_acquire(key)) {
+                return *value;
+            }
+            return std::nullopt;
+        }
+
+        auto insert(uint64 key, uint64 value) noexcept -> uint64 {
+            auto lock = std::lock_guard(_lock);
+            return _cache.insert(key, value);
+        }
+
+    private:
+        std::mutex _lock;
+        cache_t<bench_cached_t> _cache;
+    };
+
+    // returns millions of lookups per second across all threads
+    template <typename C>
+    static auto run(C& cache, uint32 threads) noexcept -> double {
+        auto is_started = std::atomic<bool>(false);
+        auto workers = std::vector<std::thread>();
+        workers.reserve(threads);
+        for (auto i = 0_u32; i < threads; ++i) {
+            workers.emplace_back([&cache, &is_started, i]() {
+                auto state = 0x9e3779b97f4a7c15_u64 * (i + 1);
+                while (!is_started.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (auto j = 0_u64; j < operations; ++j) {
+                    state = state * 6364136223846793005_u64 + 1442695040888963407_u64;
+                    const auto key = (state >> 33) % key_count;
+                    if (!cache.try_acquire(key)) {
+                        (void)cache.insert(key, key);
+                    }
+                }
+            });
+        }
+        const auto begin = std::chrono::steady_clock::now();
+        is_started.store(true, std::memory_order_release);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return static_cast<double>(operations * threads) / seconds / 1'000'000.0;
+    }
+}
+
+auto main() -> int {
+    using namespace ir;
+    std::printf("%8s %16s %20s\n", "threads", "cache_t + mutex", "concurrent_cache_t");
+    for (auto threads = 1_u32; threads <= 32; threads *= 2) {
+        auto locked = locked_cache_t();
+        auto concurrent = concurrent_cache_t<bench_cached_t>();
+        const auto locked_rate = run(locked, threads);
+        const auto concurrent_rate = run(concurrent, threads);
+        std::printf("%8u %12.2f M/s %16.2f M/s\n", threads, locked_rate, concurrent_rate);
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <iris/core/job_system.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace ir {
+    using bench_clock_t = std::chrono::steady_clock;
+
+    constexpr static auto spawn_count = 65536_u32;
+    constexpr static auto parallel_for_count = 65536_u32;
+    constexpr static auto parallel_for_batch = 64_u32;
+    constexpr static auto wait_rounds = 10000_u32;
+
+    static auto elapsed_ns(bench_clock_t::time_point begin) noexcept -> double {
+        return std::chrono::duration<double, std::nano>(bench_clock_t::now() - begin).count();
+    }
+
+    // empty jobs spawned from the main thread, then drained by wait()
+    static auto bench_spawn(job_system_t& system) noexcept -> void {
+        auto counter = job_counter_t();
+        const auto begin = bench_clock_t::now();
+        for (auto i = 0_u32; i < spawn_count; ++i) {
+            system.spawn([]() {}, &counter);
+        }
+        const auto spawned = elapsed_ns(begin);
+        system.wait(counter);
+        const auto drained = elapsed_ns(begin);
+        std::printf("spawn:        %8.1f ns/job spawned, %8.1f ns/job until drained\n", spawned / spawn_count, drained / spawn_count);
+    }
+
+    // parallel_for from inside a job, the batches land in one worker's deque and every other worker steals them
+    static auto bench_steal(job_system_t& system) noexcept -> void {
+        auto sum = std::atomic<uint64>(0);
+        auto counter = job_counter_t();
+        const auto begin = bench_clock_t::now();
+        system.spawn([&system, &sum]() {
+            system.parallel_for(parallel_for_count, parallel_for_batch, [&sum](uint32 first, uint32 last) {
+                auto local = 0_u64;
+                for (auto i = first; i < last; ++i) {
+                    local += static_cast<uint64>(i) * i;
+                }
+                sum.fetch_add(local, std::memory_order_relaxed);
+            });
+        }, &counter);
+        system.wait(counter);
+        const auto total = elapsed_ns(begin);
+        const auto batches = (parallel_for_count + parallel_for_batch - 1) / parallel_for_batch;
+        std::printf("parallel_for: %8.1f us total, %8.1f ns/batch (checksum %llu)\n",
+            total / 1000.0, total / batches, static_cast<unsigned long long>(sum.load()));
+    }
+
+    // round trip of one empty job, from spawn until wait() returns
+    static auto bench_wait(job_system_t& system) noexcept -> void {
+        auto total = 0.0;
+        for (auto i = 0_u32; i < wait_rounds; ++i) {
+            auto counter = job_counter_t();
+            const auto begin = bench_clock_t::now();
+            system.spawn([]() {}, &counter);
+            system.wait(counter);
+            total += elapsed_ns(begin);
+        }
+        std::printf("wait:         %8.1f ns/round trip\n", total / wait_rounds);
+    }
+}
+
+auto main() -> int {
+    using namespace ir;
+    auto system = job_system_t::make({
+        .name = "bench_job_system",
+    });
+    std::printf("workers: %u\n", system->worker_count());
+    bench_spawn(*system);
+    bench_steal(*system);
+    bench_wait(*system);
+    return 0;
+}
@@ -18,12 +18,24 @@ namespace ir {
     struct render_pass_create_info_t;
     struct command_pool_create_info_t;
     struct command_buffer_create_info_t;
+    struct command_buffer_inheritance_info_t;
     struct framebuffer_create_info_t;
     struct graphics_pipeline_create_info_t;
     struct buffer_create_info_t;
+    struct buffer_arena_create_info_t;
+    struct buffer_arena_allocation_t;
+    struct buffer_arena_relocation_t;
+    struct buffer_arena_stats_t;
     struct sampler_create_info_t;
     struct texture_create_info_t;
     struct semaphore_create_info_t;
+    struct upload_ring_create_info_t;
+    struct frame_allocator_create_info_t;
+    struct frame_allocation_t;
+    struct upload_handle_t;
+    struct upload_image_region_t;
+    struct upload_buffer_info_t;
+    struct upload_image_info_t;
 
     enum class sample_count_t : uint32;
     enum class image_usage_t : uint32;
@@ -91,6 +103,7 @@ namespace ir {
 
     struct image_info_t;
     struct buffer_info_t;
+    struct upload_allocation_t;
     struct descriptor_content_t;
     struct descriptor_set_binding_t;
 
@@ -99,9 +112,33 @@ namespace ir {
     struct extent_2d_t;
     struct extent_3d_t;
     struct image_subresource_t;
+    struct image_state_t;
 
     template <typename>
     struct cache_entry_t;
+    struct cache_stats_t;
+    struct memory_heap_stats_t;
+    struct memory_stats_t;
+    enum class memory_pressure_t;
+    enum class buffer_placement_t;
+    struct defragmenter_create_info_t;
+    struct defragmentation_target_t;
+    struct defragmentation_stats_t;
+    struct transient_allocator_create_info_t;
+    struct transient_lifetime_t;
+    struct transient_buffer_create_info_t;
+    struct transient_resource_t;
+    struct transient_allocator_stats_t;
+    struct render_graph_create_info_t;
+    struct render_graph_resource_t;
+    struct render_graph_usage_t;
+    struct render_graph_pass_info_t;
+    struct render_graph_execute_info_t;
+    struct render_graph_stats_t;
+    struct async_compute_create_info_t;
+    struct async_reduce_info_t;
+    struct resource_pool_stats_t;
+    struct job_system_create_info_t;
 
     enum class keyboard_t;
     struct cursor_position_t;
@@ -119,6 +156,7 @@ namespace ir {
     class swapchain_t;
     class render_pass_t;
     class command_pool_t;
+    class barrier_batch_t;
     class command_buffer_t;
     class framebuffer_t;
     class fence_t;
@@ -126,17 +164,31 @@ namespace ir {
     class clear_value_t;
     class pipeline_t;
     class master_frame_counter_t;
+    class frame_allocator_t;
     class frame_counter_t;
     class descriptor_layout_t;
     class descriptor_pool_t;
     template <typename>
     class buffer_t;
+    class buffer_arena_t;
     class descriptor_set_t;
     class deletion_queue_t;
+    class defragmenter_t;
     template <typename>
     class cache_t;
+    template <typename, uint32>
+    class concurrent_cache_t;
+    class resource_pool_t;
     class sampler_t;
     class texture_t;
+    class transient_allocator_t;
+    class render_graph_builder_t;
+    class render_graph_t;
+    class async_compute_t;
+    class upload_ring_t;
+    class upload_service_t;
+    class job_counter_t;
+    class job_system_t;
 
     class ngx_wrapper_t;
 
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <iris/core/macros.hpp>
+#include <iris/core/types.hpp>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ir {
+    template <typename, uint64 = 48>
+    class inplace_function_t;
+
+    // move-only callable stored in place, callables larger than the buffer are rejected at compile time
+    template <typename R, typename... Args, uint64 N>
+    class inplace_function_t<R(Args...), N> {
+    public:
+        using self = inplace_function_t;
+
+        inplace_function_t() noexcept = default;
+
+        template <typename F>
+            requires (!std::is_same_v<std::remove_cvref_t<F>, self> && std::is_invocable_r_v<R, F&, Args...>)
+        inplace_function_t(F&& callable) noexcept {
+            using callable_type = std::remove_cvref_t<F>;
+            static_assert(sizeof(callable_type) <= N, "callable does not fit the inplace buffer");
+            static_assert(alignof(callable_type) <= alignof(std::max_align_t), "callable is over-aligned");
+            static_assert(std::is_nothrow_move_constructible_v<callable_type>, "callable must be nothrow movable");
+            new (&_storage) callable_type(std::forward<F>(callable));
+            _invoke = [](void* storage, Args... args) -> R {
+                return (*static_cast<callable_type*>(storage))(std::forward<Args>(args)...);
+            };
+            _manage = [](void* dest, void* source) noexcept {
+                if (dest) {
+                    new (dest) callable_type(std::move(*static_cast<callable_type*>(source)));
+                }
+                static_cast<callable_type*>(source)->~callable_type();
+            };
+        }
+
+        ~inplace_function_t() noexcept {
+            _reset();
+        }
+
+        inplace_function_t(const self&) = delete;
+        auto operator =(const self&) -> self& = delete;
+
+        inplace_function_t(self&& other) noexcept {
+            _take(other);
+        }
+
+        auto operator =(self&& other) noexcept -> self& {
+            if (this != &other) {
+                _reset();
+                _take(other);
+            }
+            return *this;
+        }
+
+        auto operator ()(Args... args) -> R {
+            return _invoke(&_storage, std::forward<Args>(args)...);
+        }
+
+        IR_NODISCARD explicit operator bool() const noexcept {
+            return _invoke != nullptr;
+        }
+
+    private:
+        auto _reset() noexcept -> void {
+            if (_manage) {
+                _manage(nullptr, &_storage);
+            }
+            _invoke = nullptr;
+            _manage = nullptr;
+        }
+
+        auto _take(self& other) noexcept -> void {
+            if (other._manage) {
+                other._manage(&_storage, &other._storage);
+            }
+            _invoke = std::exchange(other._invoke, nullptr);
+            _manage = std::exchange(other._manage, nullptr);
+        }
+
+        alignas(std::max_align_t) std::byte _storage[N] = {};
+        R (*_invoke)(void*, Args...) = nullptr;
+        void (*_manage)(void*, void*) noexcept = nullptr;
+    };
+}
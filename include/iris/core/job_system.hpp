@@ -0,0 +1,109 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/inplace_function.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/types.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ir {
+    using job_function_t = inplace_function_t<void(), 64>;
+
+    struct job_system_create_info_t {
+        std::string name = {};
+        // 0 => one worker per hardware thread besides the calling thread
+        uint32 workers = 0;
+    };
+
+    // counts the unfinished jobs spawned against it, must outlive every job and continuation it tracks
+    class job_counter_t {
+    public:
+        using self = job_counter_t;
+
+        job_counter_t() noexcept;
+        ~job_counter_t() noexcept;
+
+        IR_DELETE_COPY(job_counter_t);
+        IR_DELETE_MOVE(job_counter_t);
+
+        IR_NODISCARD auto pending() const noexcept -> uint64;
+        IR_NODISCARD auto is_done() const noexcept -> bool;
+
+    private:
+        friend class job_system_t;
+
+        struct continuation_t {
+            job_function_t function;
+            job_counter_t* counter = nullptr;
+        };
+
+        std::atomic<uint64> _pending = 0;
+        std::vector<continuation_t> _continuations;
+        mutable std::mutex _lock;
+    };
+
+    // work-stealing scheduler, each worker pops its own deque from the back and steals from the front of the others
+    class job_system_t : public enable_intrusive_refcount_t<job_system_t> {
+    public:
+        using self = job_system_t;
+
+        job_system_t() noexcept;
+        ~job_system_t() noexcept;
+
+        IR_NODISCARD static auto make(const job_system_create_info_t& info = {}) noexcept -> arc_ptr<self>;
+
+        // worker index of the calling thread, -1 outside of this system's workers
+        IR_NODISCARD auto worker_index() const noexcept -> uint32;
+        IR_NODISCARD auto worker_count() const noexcept -> uint32;
+        IR_NODISCARD auto info() const noexcept -> const job_system_create_info_t&;
+
+        auto spawn(job_function_t function, job_counter_t* counter = nullptr) noexcept -> void;
+        // runs once dependency drops to zero, counter is signaled as if spawned right away
+        auto spawn_after(job_counter_t& dependency, job_function_t function, job_counter_t* counter = nullptr) noexcept -> void;
+        // splits [0, count) into batches of at most batch indices
+        auto parallel_for(uint32 count, uint32 batch, const std::function<void(uint32, uint32)>& function) noexcept -> void;
+
+        // the waiting thread runs pending jobs instead of blocking, safe from the main thread and from jobs
+        auto wait(const job_counter_t& counter) noexcept -> void;
+
+    private:
+        struct job_t {
+            job_function_t function;
+            job_counter_t* counter = nullptr;
+        };
+
+        struct worker_t {
+            std::deque<job_t> jobs;
+            std::mutex lock;
+            std::thread thread;
+        };
+
+        auto _push(job_t job) noexcept -> void;
+        auto _pop(uint32 index, job_t& job) noexcept -> bool;
+        auto _run(job_t& job) noexcept -> void;
+        auto _signal(job_counter_t* counter) noexcept -> void;
+        auto _work(uint32 index) noexcept -> void;
+
+        std::vector<std::unique_ptr<worker_t>> _workers;
+        // jobs spawned from threads outside of the workers
+        std::deque<job_t> _injected;
+        std::mutex _injected_lock;
+
+        std::atomic<uint64> _queued = 0;
+        std::atomic<bool> _is_running = true;
+        std::condition_variable _wake;
+        std::mutex _wake_lock;
+
+        job_system_create_info_t _info = {};
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <iris/core/macros.hpp>
+#include <iris/core/types.hpp>
+
+#include <atomic>
+#include <utility>
+
+namespace ir {
+    // unbounded multi-producer single-consumer queue, push() is a single exchange and never waits on other producers,
+    // pop() may briefly miss an element whose producer is between its exchange and its link
+    template <typename T>
+    class mpsc_queue_t {
+    public:
+        using self = mpsc_queue_t;
+
+        mpsc_queue_t() noexcept
+            : _head(&_stub),
+              _tail(&_stub) {
+        }
+
+        ~mpsc_queue_t() noexcept {
+            auto value = T();
+            while (pop(value)) {
+            }
+            if (_tail != &_stub) {
+                delete _tail;
+            }
+        }
+
+        IR_DELETE_COPY(mpsc_queue_t);
+        IR_DELETE_MOVE(mpsc_queue_t);
+
+        auto push(T value) noexcept -> void {
+            auto* node = new node_t();
+            node->value = std::move(value);
+            auto* previous = _head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        // consumer only
+        IR_NODISCARD auto pop(T& value) noexcept -> bool {
+            auto* tail = _tail;
+            auto* next = tail->next.load(std::memory_order_acquire);
+            if (!next) {
+                return false;
+            }
+            // note: the popped node becomes the new sentinel, its value is moved out
+            value = std::move(next->value);
+            _tail = next;
+            if (tail != &_stub) {
+                delete tail;
+            }
+            return true;
+        }
+
+    private:
+        struct node_t {
+            std::atomic<node_t*> next = nullptr;
+            T value = {};
+        };
+
+        node_t _stub;
+        std::atomic<node_t*> _head;
+        // consumer owned
+        node_t* _tail;
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/hash.hpp>
+#include <iris/core/types.hpp>
+
+#include <iris/gfx/image.hpp>
+#include <iris/gfx/render_graph.hpp>
+
+#include <volk.h>
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+
+namespace ir {
+    struct async_compute_create_info_t {
+        std::string name = {};
+        // hiz_reduce.comp and shadow_page_reduce.comp, a reduction can only be added when its shader is set
+        fs::path hiz_reduce;
+        fs::path shadow_page_reduce;
+    };
+
+    struct async_reduce_info_t {
+        // level 0 is written by an earlier pass, every other level is reduced from the one above it
+        render_graph_resource_t image = {};
+        // only consumed by the next frame, see render_graph_pass_info_t::is_detached
+        bool is_detached = true;
+    };
+
+    // adds the depth and shadow page hierarchy reductions and the next frame's culling to a render graph
+    // as async compute passes, they overlap the frame's graphics work on devices with a separate compute queue
+    class async_compute_t : public enable_intrusive_refcount_t<async_compute_t> {
+    public:
+        using self = async_compute_t;
+
+        async_compute_t(device_t& device) noexcept;
+        ~async_compute_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device, const async_compute_create_info_t& info) noexcept -> arc_ptr<self>;
+
+        // min depth reduction of a sampled r32f hierarchy, must outlive the graph's execute()
+        auto add_hiz_reduce(render_graph_t& graph, const async_reduce_info_t& info) noexcept -> void;
+        // any-page reduction of an r8ui storage hierarchy, must outlive the graph's execute()
+        auto add_shadow_page_reduce(render_graph_t& graph, const async_reduce_info_t& info) noexcept -> void;
+        // culling for the next frame, its results are waited on by the next frame's first graphics submission
+        auto add_cull(
+            render_graph_t& graph,
+            const std::string& name,
+            const render_graph_t::setup_function_t& setup,
+            render_graph_t::execute_function_t execute
+        ) noexcept -> void;
+
+        IR_NODISCARD auto info() const noexcept -> const async_compute_create_info_t&;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+    private:
+        struct level_views_t {
+            VkImage handle = {};
+            std::vector<arc_ptr<image_view_t>> views;
+        };
+
+        auto _reduce(
+            render_graph_t& graph,
+            const std::string& name,
+            const pipeline_t& pipeline,
+            const async_reduce_info_t& info,
+            bool is_sampled
+        ) noexcept -> void;
+        // one view per level, made again every frame and when the image is relocated
+        IR_NODISCARD auto _views(const image_t& image) noexcept -> const std::vector<arc_ptr<image_view_t>>&;
+
+        arc_ptr<pipeline_t> _hiz_reduce;
+        arc_ptr<pipeline_t> _shadow_page_reduce;
+        arc_ptr<sampler_t> _sampler;
+        akl::fast_hash_map<const image_t*, level_views_t> _level_views;
+        // frame the cached level views were made in
+        uint64 _frame = -1_u64;
+
+        async_compute_create_info_t _info = {};
+        std::reference_wrapper<device_t> _device;
+    };
+}
@@ -1,15 +1,19 @@
 #pragma once
 
 #include <iris/core/forwards.hpp>
+#include <iris/core/hash.hpp>
 #include <iris/core/intrusive_atomic_ptr.hpp>
 #include <iris/core/macros.hpp>
 #include <iris/core/enums.hpp>
 #include <iris/core/types.hpp>
 
 #include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/defragmenter.hpp>
 #include <iris/gfx/device.hpp>
 #include <iris/gfx/queue.hpp>
 #include <iris/gfx/fence.hpp>
+#include <iris/gfx/upload_ring.hpp>
+#include <iris/gfx/upload_service.hpp>
 
 #include <volk.h>
 #include <vk_mem_alloc.h>
@@ -29,6 +33,12 @@ namespace ir {
         e_mapped = 1 << 1,
         e_random_access = 1 << 2,
         e_resized = 1 << 3,
+        // growth copies the previous contents into the new allocation
+        e_preserved = 1 << 4,
+        // the defragmenter may relocate the buffer, handle() and address() change after a pass, ignored when mapped
+        e_movable = 1 << 5,
+        // capacity reserves a virtual range, reserve() commits device memory in pages without moving the buffer
+        e_sparse = 1 << 6,
     };
 
     struct memory_properties_t {
@@ -40,6 +50,8 @@ namespace ir {
     constexpr static auto infer_memory_properties = memory_properties_t();
 
     struct buffer_create_info_t {
+        auto operator ==(const buffer_create_info_t& other) const noexcept -> bool = default;
+
         std::string name = {};
         buffer_usage_t usage = {};
         memory_properties_t memory = infer_memory_properties;
@@ -55,8 +67,8 @@ namespace ir {
         buffer_t() noexcept;
         ~buffer_t() noexcept;
 
-        IR_NODISCARD static auto make(const device_t& device, const buffer_create_info_t& info) noexcept -> arc_ptr<self>;
-        IR_NODISCARD static auto make(const device_t& device, uint32 count, const buffer_create_info_t& info) noexcept -> std::vector<arc_ptr<self>>;
+        IR_NODISCARD static auto make(device_t& device, const buffer_create_info_t& info) noexcept -> arc_ptr<self>;
+        IR_NODISCARD static auto make(device_t& device, uint32 count, const buffer_create_info_t& info) noexcept -> std::vector<arc_ptr<self>>;
 
         IR_NODISCARD auto handle() const noexcept -> VkBuffer;
         IR_NODISCARD auto memory() const noexcept -> VkDeviceMemory;
@@ -86,6 +98,7 @@ namespace ir {
         IR_NODISCARD auto is_empty() const noexcept -> bool;
         IR_NODISCARD auto is_shared() const noexcept -> bool;
         IR_NODISCARD auto is_seq_write_only() const noexcept -> bool;
+        IR_NODISCARD auto is_sparse() const noexcept -> bool;
 
         IR_NODISCARD auto operator [](uint64 index) noexcept -> T&;
         IR_NODISCARD auto operator [](uint64 index) const noexcept -> const T&;
@@ -106,14 +119,23 @@ namespace ir {
         auto push_back(const T& value) noexcept -> void;
         auto pop_back() noexcept -> void;
 
-        // potentially destructive
+        // destructive unless the buffer is e_preserved
         auto resize(uint64 size) noexcept -> void;
-        // potentially destructive
+        // destructive unless the buffer is e_preserved
         auto reserve(uint64 capacity) noexcept -> void;
         auto clear() noexcept -> void;
 
     private:
-        static auto _make(const device_t& device, const buffer_create_info_t& info, self* buffer) noexcept -> void;
+        friend class resource_pool_t;
+
+        static auto _make(device_t& device, const buffer_create_info_t& info, self* buffer) noexcept -> void;
+        static auto _create_info(device_t& device, const buffer_create_info_t& info, std::array<uint32, 3>& families) noexcept -> VkBufferCreateInfo;
+
+        IR_NODISCARD auto _is_movable() const noexcept -> bool;
+        auto _relocate(command_buffer_t& command_buffer, VmaAllocation allocation) noexcept -> bool;
+        auto _commit(uint64 capacity) noexcept -> void;
+        // pooled buffers must not keep the device alive, the device owns the resource pool
+        auto _pin(bool is_pinned) noexcept -> void;
 
         VkBuffer _handle = {};
         VmaAllocation _allocation = {};
@@ -126,35 +148,42 @@ namespace ir {
 
         void* _data = nullptr;
 
+        // committed pages of a sparse buffer, in resource order
+        std::vector<VmaAllocation> _pages;
+        uint64 _page_size = 0;
+        uint32 _memory_type_bits = 0;
+
         buffer_create_info_t _info = {};
-        arc_ptr<const device_t> _device;
+        device_t* _device = nullptr;
+        arc_ptr<device_t> _device_pin;
     };
 
     template <typename T>
     auto upload_buffer(device_t& device, std::span<const T> data, const buffer_create_info_t& info) noexcept -> arc_ptr<buffer_t<T>> {
         IR_PROFILE_SCOPED();
-        auto staging = buffer_t<T>::make(device, {
-            .usage = buffer_usage_t::e_transfer_src,
-            .flags = buffer_flag_t::e_mapped,
-            .capacity = data.size(),
-        });
+        // note: direct placement skips the staging copy, the fallback memory is still host-visible
+        if (device.buffer_placement(data.size_bytes()) == buffer_placement_t::e_direct) {
+            auto direct = buffer_t<T>::make(device, {
+                .usage = info.usage,
+                .memory = info.memory,
+                .flags = info.flags | buffer_flag_t::e_mapped | buffer_flag_t::e_resized,
+                .capacity = data.size(),
+            });
+            std::memcpy(direct->data(), data.data(), data.size_bytes());
+            return direct;
+        }
         auto upload = buffer_t<T>::make(device, {
             .usage = buffer_usage_t::e_transfer_dst | info.usage,
             .memory = info.memory,
             .flags = info.flags | buffer_flag_t::e_resized,
             .capacity = data.size(),
         });
-        staging->insert(data);
-        const auto& pool = device.transfer_queue().transient_pool(0);
-        auto command_buffer = command_buffer_t::make(pool, {});
-        command_buffer->begin();
-        command_buffer->copy_buffer(staging->slice(), upload->slice(), {});
-        command_buffer->end();
-        auto fence = fence_t::make(device, false);
-        device.transfer_queue().submit({
-            .command_buffers = { std::cref(*command_buffer) }
-        }, fence.get());
-        fence->wait();
+        auto& service = device.upload_service();
+        service.wait(service.upload(upload_buffer_info_t {
+            .dest = upload->slice(),
+            .data = std::span(reinterpret_cast<const uint8*>(data.data()), data.size_bytes()),
+            .is_shared = upload->is_shared(),
+        }));
         return upload;
     }
 
@@ -165,11 +194,19 @@ namespace ir {
     buffer_t<T>::~buffer_t() noexcept {
         IR_PROFILE_SCOPED();
         IR_LOG_INFO(device().logger(), "destroying buffer {}", fmt::ptr(_handle));
-        vmaDestroyBuffer(device().allocator(), _handle, _allocation);
+        if (_is_movable()) {
+            device().defragmenter().untrack(_allocation);
+        }
+        device().deletion_queue().push([handle = _handle, allocation = _allocation, pages = std::move(_pages)](device_t& device) {
+            vmaDestroyBuffer(device.allocator(), handle, allocation);
+            if (!pages.empty()) {
+                vmaFreeMemoryPages(device.allocator(), pages.size(), pages.data());
+            }
+        });
     }
 
     template <typename T>
-    auto buffer_t<T>::make(const device_t& device, const buffer_create_info_t& info) noexcept -> arc_ptr<self> {
+    auto buffer_t<T>::make(device_t& device, const buffer_create_info_t& info) noexcept -> arc_ptr<self> {
         IR_PROFILE_SCOPED();
         auto buffer = arc_ptr<self>(new self());
         _make(device, info, buffer.get());
@@ -177,7 +214,7 @@ namespace ir {
     }
 
     template <typename T>
-    auto buffer_t<T>::make(const device_t& device, uint32 count, const buffer_create_info_t& info) noexcept -> std::vector<arc_ptr<self>> {
+    auto buffer_t<T>::make(device_t& device, uint32 count, const buffer_create_info_t& info) noexcept -> std::vector<arc_ptr<self>> {
         IR_PROFILE_SCOPED();
         auto buffers = std::vector<arc_ptr<self>>(count);
         for (auto i = 0_u32; i < count; ++i) {
@@ -323,6 +360,12 @@ namespace ir {
         return (_info.flags & buffer_flag_t::e_random_access) != buffer_flag_t::e_random_access;
     }
 
+    template <typename T>
+    auto buffer_t<T>::is_sparse() const noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        return (_info.flags & buffer_flag_t::e_sparse) == buffer_flag_t::e_sparse;
+    }
+
     template <typename T>
     auto buffer_t<T>::operator [](uint64 index) noexcept -> T& {
         IR_PROFILE_SCOPED();
@@ -426,14 +469,46 @@ namespace ir {
     template <typename T>
     auto buffer_t<T>::reserve(uint64 capacity) noexcept -> void {
         IR_PROFILE_SCOPED();
-        if (_capacity <= capacity) {
+        if (capacity <= _capacity) {
+            return;
+        }
+        if (is_sparse()) {
+            // note: the virtual range never moves, growth only binds more pages
+            _commit(std::min(capacity, _info.capacity));
             return;
         }
         IR_LOG_WARN(device().logger(), "growing buffer capacity {} -> {}", _capacity, capacity);
-        auto old_handle = _handle;
-        auto old_allocation = _allocation;
-        _make(device(), info(), this);
-        vmaDestroyBuffer(device().allocator(), old_handle, old_allocation);
+        const auto is_preserved = (_info.flags & buffer_flag_t::e_preserved) == buffer_flag_t::e_preserved;
+        const auto old_handle = _handle;
+        const auto old_allocation = _allocation;
+        const auto old_data = _data;
+        const auto old_size = _size;
+        auto info = _info;
+        info.capacity = capacity;
+        auto& device = *_device;
+        if (_is_movable()) {
+            device.defragmenter().untrack(old_allocation);
+        }
+        _make(device, info, this);
+        if (is_preserved && old_size != 0) {
+            const auto bytes = old_size * sizeof(T);
+            if (_data) {
+                std::memcpy(_data, old_data, bytes);
+            } else {
+                device.graphics_queue().submit([&](command_buffer_t& command_buffer) {
+                    command_buffer.copy_buffer({
+                        .handle = old_handle,
+                        .offset = 0,
+                        .size = bytes,
+                    }, slice(0, old_size), {});
+                });
+            }
+        }
+        _size = old_size;
+        // note: frames still in flight may reference the old allocation
+        device.deletion_queue().push([old_handle, old_allocation](device_t& device) {
+            vmaDestroyBuffer(device.allocator(), old_handle, old_allocation);
+        });
     }
 
     template <typename T>
@@ -443,49 +518,57 @@ namespace ir {
     }
 
     template <typename T>
-    auto buffer_t<T>::_make(const device_t& device, const buffer_create_info_t& info, self* buffer) noexcept -> void {
+    auto buffer_t<T>::_make(device_t& device, const buffer_create_info_t& info, self* buffer) noexcept -> void {
         IR_PROFILE_SCOPED();
         const auto is_bda_supported = device.is_supported(device_feature_t::e_buffer_device_address);
-        const auto is_shared = (info.flags & buffer_flag_t::e_shared) == buffer_flag_t::e_shared;
         const auto is_mapped = (info.flags & buffer_flag_t::e_mapped) == buffer_flag_t::e_mapped;
         const auto is_random_access = (info.flags & buffer_flag_t::e_random_access) == buffer_flag_t::e_random_access;
         const auto is_resized = (info.flags & buffer_flag_t::e_resized) == buffer_flag_t::e_resized;
-        auto buffer_usage = info.usage;
-        if (is_bda_supported) {
-            buffer_usage |= buffer_usage_t::e_shader_device_address;
-        }
-        auto queue_families = std::to_array({
-            device.graphics_queue().family(),
-            device.compute_queue().family(),
-            device.transfer_queue().family(),
-        });
-        auto queue_family_count = 1_u32;
-        if (queue_families[0] != queue_families[1]) {
-            queue_family_count++;
-        } else if (queue_families[0] != queue_families[2]) {
-            queue_family_count++;
-            std::swap(queue_families[1], queue_families[2]);
-        }
-        if (queue_families[0] != queue_families[2] &&
-            queue_families[1] != queue_families[2] &&
-            queue_families[0] != queue_families[1]) {
-            queue_family_count++;
-        }
-
-        auto buffer_info = VkBufferCreateInfo();
-        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        buffer_info.pNext = nullptr;
-        buffer_info.flags = {};
-        buffer_info.size = info.capacity * sizeof(T);
-        buffer_info.usage = as_enum_counterpart(buffer_usage);
-        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        if (is_shared && queue_family_count >= 2) {
-            buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
-            buffer_info.queueFamilyIndexCount = queue_family_count;
-            buffer_info.pQueueFamilyIndices = queue_families.data();
+        const auto is_sparse = (info.flags & buffer_flag_t::e_sparse) == buffer_flag_t::e_sparse;
+        auto queue_families = std::array<uint32, 3>();
+        const auto buffer_info = _create_info(device, info, queue_families);
+        IR_ASSERT(!is_sparse || !is_mapped, "buffer_t: sparse buffers cannot be mapped");
+
+        if (is_sparse) {
+            IR_VULKAN_CHECK(device.logger(), vkCreateBuffer(device.handle(), &buffer_info, nullptr, &buffer->_handle));
+            IR_LOG_INFO(device.logger(), "reserved sparse buffer {}, (size: {}, usage: {})",
+                fmt::ptr(buffer->_handle),
+                info.capacity,
+                as_string(static_cast<buffer_usage_t>(buffer_info.usage)));
+            auto memory_requirements = VkMemoryRequirements();
+            vkGetBufferMemoryRequirements(device.handle(), buffer->_handle, &memory_requirements);
+            buffer->_alignment = memory_requirements.alignment;
+            // note: sparse memory is bound in units of the buffer alignment
+            buffer->_page_size = memory_requirements.alignment;
+            buffer->_memory_type_bits = memory_requirements.memoryTypeBits;
+            buffer->_capacity = 0;
+            buffer->_size = 0;
+            if (is_bda_supported) {
+                auto bda_info = VkBufferDeviceAddressInfo();
+                bda_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+                bda_info.pNext = nullptr;
+                bda_info.buffer = buffer->_handle;
+                buffer->_address = vkGetBufferDeviceAddress(device.handle(), &bda_info);
+            }
+            buffer->_info = info;
+            buffer->_device = &device;
+            buffer->_device_pin = device.as_intrusive_ptr();
+            if (!info.name.empty()) {
+                device.set_debug_name({
+                    .type = VK_OBJECT_TYPE_BUFFER,
+                    .handle = reinterpret_cast<uint64>(buffer->_handle),
+                    .name = info.name.c_str(),
+                });
+            }
+            if (is_resized) {
+                buffer->_commit(info.capacity);
+                buffer->_size = info.capacity;
+            }
+            return;
         }
 
         auto memory_usage = info.memory;
+        auto memory_placement = VMA_MEMORY_USAGE_AUTO;
         auto allocation_extra_info = VmaAllocationInfo();
         auto allocation_info = VmaAllocationCreateInfo();
         if (is_mapped) {
@@ -496,28 +579,51 @@ namespace ir {
                 memory_usage.required |= memory_property_t::e_host_cached;
             } else {
                 allocation_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+                // note: staging buffers stay in system memory, everything else is written straight into VRAM when it fits
+                const auto is_staging = info.usage == buffer_usage_t::e_transfer_src;
+                if (!is_staging && device.buffer_placement(buffer_info.size) == buffer_placement_t::e_direct) {
+                    memory_placement = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+                    memory_usage.preferred |= memory_property_t::e_device_local;
+                }
             }
         }
-        allocation_info.usage = VMA_MEMORY_USAGE_AUTO;
+        allocation_info.usage = memory_placement;
         allocation_info.requiredFlags = as_enum_counterpart(memory_usage.required);
         allocation_info.preferredFlags = as_enum_counterpart(memory_usage.preferred);
         allocation_info.memoryTypeBits = {};
         allocation_info.pool = {};
         allocation_info.pUserData = nullptr;
         allocation_info.priority = 1.0f;
-        IR_VULKAN_CHECK(
-            device.logger(),
-            vmaCreateBuffer(
+        if (device.memory_pressure() != memory_pressure_t::e_none) {
+            allocation_info.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+        }
+        auto result = vmaCreateBuffer(
+            device.allocator(),
+            &buffer_info,
+            &allocation_info,
+            &buffer->_handle,
+            &buffer->_allocation,
+            &allocation_extra_info);
+        if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY && !is_mapped) {
+            // note: over budget, place the buffer in host memory rather than fail
+            IR_LOG_WARN(device.logger(), "buffer of size {} does not fit in device memory, falling back to host memory", info.capacity);
+            allocation_info.flags &= ~VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+            allocation_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+            allocation_info.requiredFlags &= ~VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            allocation_info.preferredFlags &= ~VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            result = vmaCreateBuffer(
                 device.allocator(),
                 &buffer_info,
                 &allocation_info,
                 &buffer->_handle,
                 &buffer->_allocation,
-                &allocation_extra_info));
+                &allocation_extra_info);
+        }
+        IR_VULKAN_CHECK(device.logger(), result);
         IR_LOG_INFO(device.logger(), "allocated buffer {}, (size: {}, usage: {})",
             fmt::ptr(buffer->_handle),
             info.capacity,
-            as_string(buffer_usage));
+            as_string(static_cast<buffer_usage_t>(buffer_info.usage)));
         auto memory_requirements = VkMemoryRequirements();
         vkGetBufferMemoryRequirements(device.handle(), buffer->_handle, &memory_requirements);
         auto memory_property = VkMemoryPropertyFlags();
@@ -540,7 +646,18 @@ namespace ir {
             buffer->_data = allocation_extra_info.pMappedData;
         }
         buffer->_info = info;
-        buffer->_device = device.as_intrusive_ptr();
+        buffer->_device = &device;
+        buffer->_device_pin = device.as_intrusive_ptr();
+        if (buffer->_is_movable()) {
+            device.defragmenter().track(buffer->_allocation, {
+                .move = [buffer](command_buffer_t& command_buffer, VmaAllocation allocation) {
+                    return buffer->_relocate(command_buffer, allocation);
+                },
+                .commit = [buffer]() {
+                    vmaGetAllocationInfo(buffer->device().allocator(), buffer->_allocation, &buffer->_allocation_info);
+                },
+            });
+        }
 
         if (!info.name.empty()) {
             device.set_debug_name({
@@ -550,4 +667,201 @@ namespace ir {
             });
         }
     }
+
+    template <typename T>
+    auto buffer_t<T>::_create_info(
+        device_t& device,
+        const buffer_create_info_t& info,
+        std::array<uint32, 3>& families
+    ) noexcept -> VkBufferCreateInfo {
+        IR_PROFILE_SCOPED();
+        const auto is_bda_supported = device.is_supported(device_feature_t::e_buffer_device_address);
+        const auto is_shared = (info.flags & buffer_flag_t::e_shared) == buffer_flag_t::e_shared;
+        const auto is_mapped = (info.flags & buffer_flag_t::e_mapped) == buffer_flag_t::e_mapped;
+        const auto is_preserved = (info.flags & buffer_flag_t::e_preserved) == buffer_flag_t::e_preserved;
+        const auto is_movable = (info.flags & buffer_flag_t::e_movable) == buffer_flag_t::e_movable;
+        const auto is_sparse = (info.flags & buffer_flag_t::e_sparse) == buffer_flag_t::e_sparse;
+        auto buffer_usage = info.usage;
+        if (is_bda_supported) {
+            buffer_usage |= buffer_usage_t::e_shader_device_address;
+        }
+        if ((is_preserved || is_movable) && !is_mapped) {
+            buffer_usage |= buffer_usage_t::e_transfer_src | buffer_usage_t::e_transfer_dst;
+        }
+        families = std::to_array({
+            device.graphics_queue().family(),
+            device.compute_queue().family(),
+            device.transfer_queue().family(),
+        });
+        auto queue_family_count = 1_u32;
+        if (families[0] != families[1]) {
+            queue_family_count++;
+        } else if (families[0] != families[2]) {
+            queue_family_count++;
+            std::swap(families[1], families[2]);
+        }
+        if (families[0] != families[2] &&
+            families[1] != families[2] &&
+            families[0] != families[1]) {
+            queue_family_count++;
+        }
+
+        auto buffer_info = VkBufferCreateInfo();
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.pNext = nullptr;
+        buffer_info.flags = {};
+        if (is_sparse) {
+            buffer_info.flags |= VK_BUFFER_CREATE_SPARSE_BINDING_BIT | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
+        }
+        buffer_info.size = info.capacity * sizeof(T);
+        buffer_info.usage = as_enum_counterpart(buffer_usage);
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (is_shared && queue_family_count >= 2) {
+            buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            buffer_info.queueFamilyIndexCount = queue_family_count;
+            buffer_info.pQueueFamilyIndices = families.data();
+        }
+        return buffer_info;
+    }
+
+    template <typename T>
+    auto buffer_t<T>::_is_movable() const noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        const auto is_movable = (_info.flags & buffer_flag_t::e_movable) == buffer_flag_t::e_movable;
+        const auto is_mapped = (_info.flags & buffer_flag_t::e_mapped) == buffer_flag_t::e_mapped;
+        return is_movable && !is_mapped && !is_sparse();
+    }
+
+    template <typename T>
+    auto buffer_t<T>::_relocate(command_buffer_t& command_buffer, VmaAllocation allocation) noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        auto& device = *_device;
+        auto queue_families = std::array<uint32, 3>();
+        const auto buffer_info = _create_info(device, _info, queue_families);
+        auto handle = VkBuffer();
+        if (vkCreateBuffer(device.handle(), &buffer_info, nullptr, &handle) != VK_SUCCESS) {
+            return false;
+        }
+        if (vmaBindBufferMemory(device.allocator(), allocation, handle) != VK_SUCCESS) {
+            vkDestroyBuffer(device.handle(), handle, nullptr);
+            return false;
+        }
+        const auto bytes = _capacity * sizeof(T);
+        command_buffer.copy_buffer({
+            .handle = _handle,
+            .offset = 0,
+            .size = bytes,
+        }, {
+            .handle = handle,
+            .offset = 0,
+            .size = bytes,
+        }, {});
+        // note: the allocation outlives the old handle, it is swapped to the new memory when the pass ends
+        device.deletion_queue().push([handle = _handle](device_t& device) {
+            vkDestroyBuffer(device.handle(), handle, nullptr);
+        });
+        _handle = handle;
+        if (device.is_supported(device_feature_t::e_buffer_device_address)) {
+            auto bda_info = VkBufferDeviceAddressInfo();
+            bda_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+            bda_info.pNext = nullptr;
+            bda_info.buffer = _handle;
+            _address = vkGetBufferDeviceAddress(device.handle(), &bda_info);
+        }
+        if (!_info.name.empty()) {
+            device.set_debug_name({
+                .type = VK_OBJECT_TYPE_BUFFER,
+                .handle = reinterpret_cast<uint64>(_handle),
+                .name = _info.name.c_str(),
+            });
+        }
+        return true;
+    }
+
+    template <typename T>
+    auto buffer_t<T>::_commit(uint64 capacity) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto& device = *_device;
+        const auto bytes = _info.capacity * sizeof(T);
+        const auto committed = _pages.size() * _page_size;
+        const auto required = std::min(capacity * sizeof(T), bytes);
+        if (required <= committed) {
+            return;
+        }
+        const auto count = (required - committed + _page_size - 1) / _page_size;
+        auto memory_requirements = VkMemoryRequirements();
+        memory_requirements.size = _page_size;
+        memory_requirements.alignment = _page_size;
+        memory_requirements.memoryTypeBits = _memory_type_bits;
+        auto allocation_info = VmaAllocationCreateInfo();
+        allocation_info.flags = {};
+        allocation_info.usage = VMA_MEMORY_USAGE_UNKNOWN;
+        allocation_info.requiredFlags = as_enum_counterpart(_info.memory.required | memory_property_t::e_device_local);
+        allocation_info.preferredFlags = as_enum_counterpart(_info.memory.preferred);
+        allocation_info.memoryTypeBits = {};
+        allocation_info.pool = {};
+        allocation_info.pUserData = nullptr;
+        allocation_info.priority = 1.0f;
+        auto pages = std::vector<VmaAllocation>(count);
+        auto pages_info = std::vector<VmaAllocationInfo>(count);
+        IR_VULKAN_CHECK(
+            device.logger(),
+            vmaAllocateMemoryPages(
+                device.allocator(),
+                &memory_requirements,
+                &allocation_info,
+                count,
+                pages.data(),
+                pages_info.data()));
+
+        auto bindings = std::vector<sparse_memory_bind_t>();
+        bindings.reserve(count);
+        for (auto i = 0_u64; i < count; ++i) {
+            const auto offset = committed + i * _page_size;
+            bindings.emplace_back(sparse_memory_bind_t {
+                .offset = offset,
+                .size = std::min(_page_size, bytes - offset),
+                .buffer = {
+                    .memory = pages_info[i].deviceMemory,
+                    .offset = pages_info[i].offset,
+                },
+            });
+        }
+        // note: growth is rare, wait for the binding so the new range is usable on return
+        auto fence = fence_t::make(device, false);
+        device.graphics_queue().bind_sparse({
+            .buffer_binds = {{
+                .buffer = _handle,
+                .bindings = std::move(bindings),
+            }},
+        }, fence.get());
+        fence->wait();
+        IR_LOG_INFO(device.logger(), "committed {} pages of sparse buffer {}", count, fmt::ptr(_handle));
+        _pages.insert(_pages.end(), pages.begin(), pages.end());
+        _capacity = std::min(_pages.size() * _page_size, bytes) / sizeof(T);
+    }
+
+    template <typename T>
+    auto buffer_t<T>::_pin(bool is_pinned) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (is_pinned) {
+            _device_pin = _device->as_intrusive_ptr();
+        } else {
+            _device_pin.reset();
+        }
+    }
 }
+
+IR_MAKE_TRANSPARENT_EQUAL_TO_SPECIALIZATION(ir::buffer_create_info_t);
+
+IR_MAKE_AVALANCHING_TRANSPARENT_HASH_SPECIALIZATION(ir::buffer_create_info_t, ([](const auto& x) -> std::size_t {
+    IR_PROFILE_SCOPED();
+    auto seed = std::size_t();
+    seed = ir::akl::hash<std::string>()(x.name);
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::buffer_usage_t>()(x.usage));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::memory_property_t>()(x.memory.required));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::memory_property_t>()(x.memory.preferred));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::buffer_flag_t>()(x.flags));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::uint64>()(x.capacity));
+    return seed;
+}));
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/enums.hpp>
+#include <iris/core/hash.hpp>
+#include <iris/core/types.hpp>
+
+#include <iris/gfx/buffer.hpp>
+
+#include <volk.h>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ir {
+    struct buffer_arena_create_info_t {
+        std::string name = {};
+        buffer_usage_t usage = {};
+        memory_properties_t memory = infer_memory_properties;
+        buffer_flag_t flags = {};
+        // in bytes
+        uint64 capacity = 0;
+    };
+
+    struct buffer_arena_allocation_t {
+        constexpr auto operator ==(const buffer_arena_allocation_t& other) const noexcept -> bool = default;
+
+        VmaVirtualAllocation handle = {};
+        uint64 offset = 0;
+        uint64 size = 0;
+    };
+
+    struct buffer_arena_relocation_t {
+        VmaVirtualAllocation previous = {};
+        buffer_arena_allocation_t allocation = {};
+    };
+
+    struct buffer_arena_stats_t {
+        uint64 allocations = 0;
+        uint64 used = 0;
+        uint64 capacity = 0;
+    };
+
+    // sub-allocates ranges of a single buffer, every range shares the buffer handle and device address
+    class buffer_arena_t : public enable_intrusive_refcount_t<buffer_arena_t> {
+    public:
+        using self = buffer_arena_t;
+
+        buffer_arena_t(device_t& device) noexcept;
+        ~buffer_arena_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device, const buffer_arena_create_info_t& info) noexcept -> arc_ptr<self>;
+
+        IR_NODISCARD auto buffer() const noexcept -> const buffer_t<uint8>&;
+        IR_NODISCARD auto address() const noexcept -> uint64;
+        IR_NODISCARD auto stats() const noexcept -> buffer_arena_stats_t;
+        IR_NODISCARD auto info() const noexcept -> const buffer_arena_create_info_t&;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+        IR_NODISCARD auto slice(const buffer_arena_allocation_t& allocation) const noexcept -> buffer_info_t;
+        IR_NODISCARD auto address(const buffer_arena_allocation_t& allocation) const noexcept -> uint64;
+        template <typename T>
+        IR_NODISCARD auto data(const buffer_arena_allocation_t& allocation) noexcept -> T*;
+
+        IR_NODISCARD auto allocate(uint64 size, uint64 alignment = 16) noexcept -> std::optional<buffer_arena_allocation_t>;
+        template <typename T>
+        IR_NODISCARD auto allocate(uint64 count) noexcept -> std::optional<buffer_arena_allocation_t>;
+        auto free(const buffer_arena_allocation_t& allocation) noexcept -> void;
+
+        // packs live ranges towards the start of the arena, the buffer and its address are kept.
+        // moved ranges get new handles and offsets, callers patch theirs from the relocations.
+        // the data is moved by the recorded copies, host writes to moved ranges wait for them to complete
+        IR_NODISCARD auto compact(command_buffer_t& command_buffer) noexcept -> std::vector<buffer_arena_relocation_t>;
+
+    private:
+        struct range_t {
+            uint64 offset = 0;
+            uint64 size = 0;
+            uint64 alignment = 0;
+        };
+
+        VmaVirtualBlock _block = {};
+        arc_ptr<buffer_t<uint8>> _buffer;
+        akl::fast_hash_map<VmaVirtualAllocation, range_t> _ranges;
+        mutable std::mutex _lock;
+
+        buffer_arena_create_info_t _info = {};
+        std::reference_wrapper<device_t> _device;
+    };
+
+    template <typename T>
+    auto buffer_arena_t::data(const buffer_arena_allocation_t& allocation) noexcept -> T* {
+        IR_PROFILE_SCOPED();
+        return reinterpret_cast<T*>(_buffer->data() + allocation.offset);
+    }
+
+    template <typename T>
+    auto buffer_arena_t::allocate(uint64 count) noexcept -> std::optional<buffer_arena_allocation_t> {
+        IR_PROFILE_SCOPED();
+        return allocate(count * sizeof(T), std::max<uint64>(alignof(T), 16));
+    }
+}
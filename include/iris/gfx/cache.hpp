@@ -9,6 +9,9 @@
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <array>
+#include <mutex>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -16,7 +19,26 @@ namespace ir {
     template <typename T>
     struct cache_entry_t {
         T value;
-        uint32 ttl = 0;
+        uint64 generation = 0;
+        // generation of the wheel bucket that owns the entry, copies left in other buckets are stale
+        uint64 armed = 0;
+    };
+
+    struct cache_stats_t {
+        uint64 hits = 0;
+        uint64 misses = 0;
+        uint64 inserts = 0;
+        uint64 evictions = 0;
+        uint64 live = 0;
+
+        constexpr auto operator +=(const cache_stats_t& other) noexcept -> cache_stats_t& {
+            hits += other.hits;
+            misses += other.misses;
+            inserts += other.inserts;
+            evictions += other.evictions;
+            live += other.live;
+            return *this;
+        }
     };
 
     template <typename T>
@@ -38,10 +60,23 @@ namespace ir {
         IR_NODISCARD auto acquire(const key_type& key) noexcept -> value_type& {
             IR_PROFILE_SCOPED();
             auto& entry = _map.at(key);
-            entry.ttl = _max_ttl;
+            entry.generation = _generation;
+            _stats.hits++;
             return entry.value;
         }
 
+        IR_NODISCARD auto try_acquire(const key_type& key) noexcept -> value_type* {
+            IR_PROFILE_SCOPED();
+            const auto it = _map.find(key);
+            if (it == _map.end()) {
+                _stats.misses++;
+                return nullptr;
+            }
+            it->second.generation = _generation;
+            _stats.hits++;
+            return &it->second.value;
+        }
+
         IR_NODISCARD auto contains(const key_type& key) const noexcept -> bool {
             IR_PROFILE_SCOPED();
             return _map.contains(key);
@@ -49,14 +84,20 @@ namespace ir {
 
         auto insert(const key_type& key, const value_type& value) noexcept -> const value_type& {
             IR_PROFILE_SCOPED();
-            const auto [ptr, _0] = _map.try_emplace(key, cache_entry_type { value, _max_ttl });
+            const auto [ptr, is_inserted] = _map.try_emplace(key, cache_entry_type { value, _generation, _generation });
+            if (is_inserted) {
+                _track(key);
+            }
             const auto& [_1, entry] = *ptr;
             return entry.value;
         }
 
         auto insert(const key_type& key, value_type&& value) noexcept -> const value_type& {
             IR_PROFILE_SCOPED();
-            const auto [ptr, _0] = _map.try_emplace(key, cache_entry_type { std::move(value), _max_ttl });
+            const auto [ptr, is_inserted] = _map.try_emplace(key, cache_entry_type { std::move(value), _generation, _generation });
+            if (is_inserted) {
+                _track(key);
+            }
             const auto& [_1, entry] = *ptr;
             return entry.value;
         }
@@ -66,28 +107,164 @@ namespace ir {
             _map.erase(key);
         }
 
+        // timing wheel: each key sits in the bucket of the generation it was last armed at. when that
+        // bucket expires, entries acquired since then are re-armed at their latest generation instead
         auto tick() noexcept -> void {
             IR_PROFILE_SCOPED();
             if constexpr (!_is_persistent) {
-                std::erase_if(_map, [](auto& entry) {
-                    if (entry.second.ttl-- == 0) {
-                        IR_LOG_INFO(spdlog::get("cache"), "cache_t: TTL expired for object {}", fmt::ptr(&entry.second.value));
-                        return true;
+                _generation++;
+                if (_generation < _wheel_size) {
+                    return;
+                }
+                const auto expired = _generation - _wheel_size;
+                auto bucket = std::move(_wheel[expired % _wheel_size]);
+                _wheel[expired % _wheel_size].clear();
+                for (auto& key : bucket) {
+                    const auto it = _map.find(key);
+                    // note: a removed and reinserted key leaves its old copy behind, only the armed one counts
+                    if (it == _map.end() || it->second.armed != expired) {
+                        continue;
+                    }
+                    if (it->second.generation != expired) {
+                        it->second.armed = it->second.generation;
+                        _wheel[it->second.generation % _wheel_size].emplace_back(std::move(key));
+                        continue;
                     }
-                    return false;
-                });
+                    IR_LOG_INFO(spdlog::get("cache"), "cache_t: TTL expired for object {}", fmt::ptr(&it->second.value));
+                    _map.erase(it);
+                    _stats.evictions++;
+                }
             }
         }
 
         auto clear() noexcept -> void {
             IR_PROFILE_SCOPED();
             _map.clear();
+            for (auto& bucket : _wheel) {
+                bucket.clear();
+            }
+        }
+
+        IR_NODISCARD auto stats() const noexcept -> cache_stats_t {
+            IR_PROFILE_SCOPED();
+            auto stats = _stats;
+            stats.live = _map.size();
+            return stats;
         }
 
     private:
         constexpr static auto _max_ttl = T::max_ttl;
         constexpr static auto _is_persistent = T::is_persistent;
+        constexpr static auto _wheel_size = _is_persistent ? 1_u64 : static_cast<uint64>(_max_ttl) + 1;
+
+        auto _track(const key_type& key) noexcept -> void {
+            IR_PROFILE_SCOPED();
+            _stats.inserts++;
+            if constexpr (!_is_persistent) {
+                _wheel[_generation % _wheel_size].emplace_back(key);
+            }
+        }
 
         akl::fast_hash_map<key_type, cache_entry_type> _map;
+        std::array<std::vector<key_type>, _wheel_size> _wheel = {};
+        uint64 _generation = 0;
+        cache_stats_t _stats = {};
+    };
+
+    // note: values are returned by copy, references into a shard are not stable across threads
+    template <typename T, uint32 S = 16>
+    class concurrent_cache_t {
+    public:
+        using self = concurrent_cache_t;
+        using key_type = typename T::cache_key_type;
+        using value_type = typename T::cache_value_type;
+
+        constexpr static auto shard_count = S;
+
+        concurrent_cache_t() noexcept = default;
+        ~concurrent_cache_t() noexcept = default;
+
+        IR_DELETE_COPY(concurrent_cache_t);
+        IR_DELETE_MOVE(concurrent_cache_t);
+
+        IR_NODISCARD auto try_acquire(const key_type& key) noexcept -> std::optional<value_type> {
+            IR_PROFILE_SCOPED();
+            auto& shard = _shard(key);
+            auto lock = std::lock_guard(shard.lock);
+            if (auto* value = shard.cache.try_acquire(key)) {
+                return *value;
+            }
+            return std::nullopt;
+        }
+
+        IR_NODISCARD auto acquire(const key_type& key) noexcept -> value_type {
+            IR_PROFILE_SCOPED();
+            auto& shard = _shard(key);
+            auto lock = std::lock_guard(shard.lock);
+            return shard.cache.acquire(key);
+        }
+
+        IR_NODISCARD auto contains(const key_type& key) noexcept -> bool {
+            IR_PROFILE_SCOPED();
+            auto& shard = _shard(key);
+            auto lock = std::lock_guard(shard.lock);
+            return shard.cache.contains(key);
+        }
+
+        // returns the resident value, if another thread raced us the passed value is discarded
+        auto insert(const key_type& key, value_type value) noexcept -> value_type {
+            IR_PROFILE_SCOPED();
+            auto& shard = _shard(key);
+            auto lock = std::lock_guard(shard.lock);
+            return shard.cache.insert(key, std::move(value));
+        }
+
+        auto remove(const key_type& key) noexcept -> void {
+            IR_PROFILE_SCOPED();
+            auto& shard = _shard(key);
+            auto lock = std::lock_guard(shard.lock);
+            shard.cache.remove(key);
+        }
+
+        auto tick() noexcept -> void {
+            IR_PROFILE_SCOPED();
+            for (auto& shard : _shards) {
+                auto lock = std::lock_guard(shard.lock);
+                shard.cache.tick();
+            }
+        }
+
+        auto clear() noexcept -> void {
+            IR_PROFILE_SCOPED();
+            for (auto& shard : _shards) {
+                auto lock = std::lock_guard(shard.lock);
+                shard.cache.clear();
+            }
+        }
+
+        IR_NODISCARD auto stats() noexcept -> cache_stats_t {
+            IR_PROFILE_SCOPED();
+            auto stats = cache_stats_t();
+            for (auto& shard : _shards) {
+                auto lock = std::lock_guard(shard.lock);
+                stats += shard.cache.stats();
+            }
+            return stats;
+        }
+
+    private:
+        struct shard_t {
+            std::mutex lock;
+            cache_t<T> cache;
+        };
+
+        IR_NODISCARD auto _shard(const key_type& key) noexcept -> shard_t& {
+            IR_PROFILE_SCOPED();
+            // remix so the shard index does not correlate with the bucket index inside the shard
+            const auto hash = akl::wyhash::mix(akl::hash<key_type>()(key), 0x9e3779b97f4a7c15_u64);
+            return _shards[hash % S];
+        }
+
+        std::array<shard_t, S> _shards;
     };
 }
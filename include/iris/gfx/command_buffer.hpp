@@ -13,6 +13,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <functional>
 #include <optional>
 #include <string>
 #include <vector>
@@ -25,6 +27,12 @@ namespace ir {
         bool primary = true;
     };
 
+    struct command_buffer_inheritance_info_t {
+        // the render pass instance the secondary command buffer is executed in
+        std::reference_wrapper<const framebuffer_t> framebuffer;
+        uint32 subpass = 0;
+    };
+
     struct draw_indirect_command_t {
         uint32 vertex_count = 0;
         uint32 instance_count = 0;
@@ -59,6 +67,8 @@ namespace ir {
         pipeline_stage_t dest_stage = pipeline_stage_t::e_none;
         resource_access_t source_access = resource_access_t::e_none;
         resource_access_t dest_access = resource_access_t::e_none;
+        uint32 source_family = queue_family_ignored;
+        uint32 dest_family = queue_family_ignored;
     };
 
     struct image_memory_barrier_t {
@@ -70,6 +80,8 @@ namespace ir {
         image_layout_t old_layout = image_layout_t::e_undefined;
         image_layout_t new_layout = image_layout_t::e_undefined;
         image_subresource_t subresource = {};
+        uint32 source_family = queue_family_ignored;
+        uint32 dest_family = queue_family_ignored;
     };
 
     struct image_copy_t {
@@ -94,6 +106,8 @@ namespace ir {
     };
 
     struct viewport_t {
+        constexpr auto operator ==(const viewport_t& other) const noexcept -> bool = default;
+
         float32 x = 0.0f;
         float32 y = 0.0f;
         float32 width = 0.0f;
@@ -101,12 +115,65 @@ namespace ir {
     };
 
     struct scissor_t {
+        constexpr auto operator ==(const scissor_t& other) const noexcept -> bool = default;
+
         int32 x = 0;
         int32 y = 0;
         uint32 width = 0;
         uint32 height = 0;
     };
 
+    // accumulates barriers and records them in a single vkCmdPipelineBarrier2
+    class barrier_batch_t {
+    public:
+        using self = barrier_batch_t;
+
+        barrier_batch_t() noexcept;
+        ~barrier_batch_t() noexcept;
+
+        IR_DEFAULT_COPY(barrier_batch_t);
+        IR_DEFAULT_MOVE(barrier_batch_t);
+
+        // global barriers are folded into one
+        auto memory_barrier(const memory_barrier_t& barrier) noexcept -> self&;
+        // buffer barriers without an ownership transfer are folded into the global barrier
+        auto buffer_barrier(const buffer_memory_barrier_t& barrier) noexcept -> self&;
+        // merged with a previous barrier on the same subresource and layout transition,
+        // the image's tracked state follows once the batch is recorded
+        auto image_barrier(const image_memory_barrier_t& barrier) noexcept -> self&;
+        // barrier from the tracked state of each subresource, nothing when it is already in a compatible state,
+        // an undefined layout keeps the current one
+        auto transition(const image_t& image, const image_state_t& state, const image_subresource_t& subresource = {}) noexcept -> self&;
+
+        IR_NODISCARD auto is_empty() const noexcept -> bool;
+        IR_NODISCARD auto dependency_info() const noexcept -> VkDependencyInfo;
+
+        // records the batch and clears it
+        auto flush(const command_buffer_t& command_buffer) noexcept -> void;
+        auto clear() noexcept -> void;
+
+    private:
+        friend class command_buffer_t;
+
+        struct image_track_t {
+            const image_t* image = nullptr;
+            image_state_t state = {};
+            image_subresource_t subresource = {};
+        };
+
+        // tracked state of the subresource once the batch is recorded
+        IR_NODISCARD auto _state(const image_t& image, uint32 level, uint32 layer) const noexcept -> image_state_t;
+        auto _track(const image_t& image, const image_state_t& state, const image_subresource_t& subresource) noexcept -> void;
+        // applied by command_buffer_t::pipeline_barrier(), in the order the barriers were added
+        auto _apply() const noexcept -> void;
+
+        VkMemoryBarrier2 _memory = {};
+        bool _has_memory = false;
+        std::vector<VkBufferMemoryBarrier2> _buffers;
+        std::vector<VkImageMemoryBarrier2> _images;
+        std::vector<image_track_t> _tracks;
+    };
+
     class command_buffer_t : public enable_intrusive_refcount_t<command_buffer_t> {
     public:
         using self = command_buffer_t;
@@ -130,13 +197,18 @@ namespace ir {
         IR_NODISCARD auto pool() const noexcept -> const command_pool_t&;
 
         auto begin() noexcept -> void;
+        // secondary only, the commands continue the render pass of the executing primary
+        auto begin(const command_buffer_inheritance_info_t& inheritance) noexcept -> void;
         auto begin_debug_marker(const std::string& name) noexcept -> void;
         auto end_debug_marker() noexcept -> void;
-        auto begin_render_pass(const framebuffer_t& framebuffer, const std::vector<clear_value_t>& clears) noexcept -> void;
-        auto set_viewport(const viewport_t& viewport, bool inverted = false) const noexcept -> void;
-        auto set_scissor(const scissor_t& scissor) const noexcept -> void;
+        // the subpass contents come from execute_commands() when secondary is set
+        auto begin_render_pass(const framebuffer_t& framebuffer, const std::vector<clear_value_t>& clears, bool secondary = false) noexcept -> void;
+        auto set_viewport(const viewport_t& viewport, bool inverted = false) noexcept -> void;
+        auto set_scissor(const scissor_t& scissor) noexcept -> void;
         auto bind_pipeline(const pipeline_t& pipeline) noexcept -> void;
         auto bind_descriptor_set(const descriptor_set_t& set) noexcept -> void;
+        // one bind per contiguous range of set indices, ranges that are already bound are skipped
+        auto bind_descriptor_sets(std::span<const std::reference_wrapper<const descriptor_set_t>> sets) noexcept -> void;
         auto bind_vertex_buffer(const buffer_info_t& buffer) const noexcept -> void;
         auto bind_index_buffer(const buffer_info_t& buffer, index_type_t type = index_type_t::e_uint32) const noexcept -> void;
         auto push_constants(shader_stage_t stage, uint32 offset, uint64 size, const void* data) const noexcept -> void;
@@ -158,15 +230,32 @@ namespace ir {
         auto memory_barrier(const memory_barrier_t& barrier) const noexcept -> void;
         auto buffer_barrier(const buffer_memory_barrier_t& barrier) const noexcept -> void;
         auto image_barrier(const image_memory_barrier_t& barrier) const noexcept -> void;
+        auto pipeline_barrier(const barrier_batch_t& batch) const noexcept -> void;
+        auto transition(const image_t& image, const image_state_t& state, const image_subresource_t& subresource = {}) const noexcept -> void;
+        auto execute_commands(const command_buffer_t& command_buffer) noexcept -> void;
+        auto execute_commands(const std::vector<std::reference_wrapper<const command_buffer_t>>& command_buffers) noexcept -> void;
 
         auto end() const noexcept -> void;
 
     private:
+        // sets bound past this index are always rebound
+        constexpr static auto max_tracked_sets = 8_u32;
+
+        // forgets the bound pipeline, sets and dynamic state, the render pass is kept
+        auto _reset_state() noexcept -> void;
+
         VkCommandBuffer _handle = {};
 
+        // binds matching the tracked state are skipped
         struct {
             const framebuffer_t* framebuffer = nullptr;
             const pipeline_t* pipeline = nullptr;
+            VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_MAX_ENUM;
+            VkPipelineLayout layout = {};
+            std::array<VkDescriptorSet, max_tracked_sets> sets = {};
+            std::optional<viewport_t> viewport;
+            bool is_viewport_inverted = false;
+            std::optional<scissor_t> scissor;
         } _state;
 
         command_buffer_create_info_t _info = {};
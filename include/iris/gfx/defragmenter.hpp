@@ -0,0 +1,89 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/hash.hpp>
+#include <iris/core/inplace_function.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/types.hpp>
+
+#include <volk.h>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <spdlog/spdlog.h>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace ir {
+    struct defragmenter_create_info_t {
+        uint64 max_bytes_per_pass = 32_MiB;
+        uint32 max_moves_per_pass = 64;
+        // frames to wait before starting a new defragmentation once the previous one converged
+        uint64 idle_frames = 1024;
+    };
+
+    struct defragmentation_target_t {
+        // binds a new handle to the temporary allocation, records the copy and swaps the handle in,
+        // returns false to leave the allocation in place
+        inplace_function_t<bool(command_buffer_t&, VmaAllocation)> move;
+        // called once the pass ends and the allocation refers to its new memory
+        inplace_function_t<void()> commit;
+    };
+
+    struct defragmentation_stats_t {
+        uint64 bytes_moved = 0;
+        uint64 bytes_freed = 0;
+        uint64 moves = 0;
+        uint64 passes = 0;
+    };
+
+    // incrementally compacts VMA default pools, only tracked allocations are ever moved
+    class defragmenter_t : public enable_intrusive_refcount_t<defragmenter_t> {
+    public:
+        using self = defragmenter_t;
+
+        defragmenter_t(device_t& device) noexcept;
+        ~defragmenter_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device, const defragmenter_create_info_t& info = {}) noexcept -> arc_ptr<self>;
+
+        IR_NODISCARD auto stats() const noexcept -> defragmentation_stats_t;
+        IR_NODISCARD auto info() const noexcept -> const defragmenter_create_info_t&;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+        auto track(VmaAllocation allocation, defragmentation_target_t target) noexcept -> void;
+        auto untrack(VmaAllocation allocation) noexcept -> void;
+
+        // records at most one bounded pass into the command buffer, returns the number of bytes moved,
+        // must be recorded ahead of the frame's other work
+        auto record(command_buffer_t& command_buffer) noexcept -> uint64;
+        // ends the recorded pass once the frame that executed it has retired
+        auto tick() noexcept -> void;
+        // invoked from record() once a pass moved resources, before the frame records anything else,
+        // baked device addresses, descriptors and framebuffers over moved images must be refreshed here
+        auto on_relocation(std::function<void()> callback) noexcept -> void;
+
+    private:
+        auto _record(command_buffer_t& command_buffer, std::vector<std::function<void()>>& callbacks) noexcept -> uint64;
+        auto _end() noexcept -> void;
+        auto _finish_pass() noexcept -> bool;
+
+        VmaDefragmentationContext _context = {};
+        VmaDefragmentationPassMoveInfo _pass = {};
+        std::vector<VmaAllocation> _moved;
+        uint64 _pass_frame = -1_u64;
+        uint64 _idle_until = 0;
+        bool _is_pass_pending = false;
+
+        akl::fast_hash_map<VmaAllocation, defragmentation_target_t> _targets;
+        std::vector<std::function<void()>> _callbacks;
+        defragmentation_stats_t _stats = {};
+        mutable std::mutex _lock;
+
+        defragmenter_create_info_t _info = {};
+        std::reference_wrapper<device_t> _device;
+    };
+}
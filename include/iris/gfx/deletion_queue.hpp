@@ -1,49 +1,80 @@
 #pragma once
 
 #include <iris/core/forwards.hpp>
+#include <iris/core/inplace_function.hpp>
 #include <iris/core/intrusive_atomic_ptr.hpp>
 #include <iris/core/macros.hpp>
 #include <iris/core/enums.hpp>
 #include <iris/core/types.hpp>
 
 #include <algorithm>
+#include <iterator>
+#include <mutex>
 #include <vector>
 
 namespace ir {
     struct deletion_queue_entry_t {
-        std::function<void(device_t&)> callback;
-        uint32 ttl = 0;
+        inplace_function_t<void(device_t&)> callback;
+        // retired once the frame counter reaches frame and the timeline, if any, reaches value
+        uint64 frame = 0;
+        arc_ptr<const semaphore_t> timeline;
+        uint64 value = 0;
     };
 
-    class deletion_queue_t {
+    class deletion_queue_t : public enable_intrusive_refcount_t<deletion_queue_t> {
     public:
         using self = deletion_queue_t;
         using entry = deletion_queue_entry_t;
 
-        deletion_queue_t() noexcept;
+        constexpr static auto frames_in_flight = 3_u64;
+
+        deletion_queue_t(device_t& device) noexcept;
         ~deletion_queue_t() noexcept;
 
-        deletion_queue_t(const self& other) noexcept = default;
-        deletion_queue_t(self&& other) noexcept = default;
-        auto operator =(const self& other) noexcept -> self& = default;
-        auto operator =(self&& other) noexcept -> self& = default;
+        IR_NODISCARD static auto make(device_t& device) noexcept -> arc_ptr<self>;
 
-        IR_NODISCARD static auto make(device_t& device) noexcept -> self;
+        IR_NODISCARD auto size() const noexcept -> uint64;
 
-        template <typename T, typename F>
+        // retires the callback once every frame currently in flight has completed
+        template <typename F>
         auto push(F&& callback) noexcept -> void;
+        // retires the callback once the timeline reaches value
+        template <typename F>
+        auto push(F&& callback, const semaphore_t& timeline, uint64 value) noexcept -> void;
 
         auto tick() noexcept -> void;
+        // runs every pending callback, the device must be idle
+        auto flush() noexcept -> void;
 
     private:
+        auto _push(entry&& entry) noexcept -> void;
+        IR_NODISCARD auto _current_frame() const noexcept -> uint64;
+
         std::vector<entry> _entries;
+        mutable std::mutex _lock;
 
-        arc_ptr<device_t> _device;
+        std::reference_wrapper<device_t> _device;
     };
 
-    template <typename T, typename F>
+    template <typename F>
     auto deletion_queue_t::push(F&& callback) noexcept -> void {
         IR_PROFILE_SCOPED();
-        _entries.push_back({ std::forward<F>(callback), T::max_ttl });
+        _push({
+            .callback = std::forward<F>(callback),
+            .frame = _current_frame() + frames_in_flight,
+            .timeline = {},
+            .value = 0,
+        });
+    }
+
+    template <typename F>
+    auto deletion_queue_t::push(F&& callback, const semaphore_t& timeline, uint64 value) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        _push({
+            .callback = std::forward<F>(callback),
+            .frame = 0,
+            .timeline = timeline.as_intrusive_ptr(),
+            .value = value,
+        });
     }
 }
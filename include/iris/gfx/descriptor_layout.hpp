@@ -29,6 +29,11 @@ namespace ir {
         IR_NODISCARD constexpr auto operator ==(const descriptor_binding_t& other) const noexcept -> bool = default;
     };
 
+    union descriptor_update_entry_t {
+        VkDescriptorImageInfo image;
+        VkDescriptorBufferInfo buffer;
+    };
+
     struct descriptor_layout_create_info_t {
         std::string name = {};
         std::span<const descriptor_binding_t> bindings;
@@ -49,6 +54,7 @@ namespace ir {
         IR_NODISCARD static auto make(device_t& device, const descriptor_layout_create_info_t& info) noexcept -> arc_ptr<self>;
 
         IR_NODISCARD auto handle() const noexcept -> VkDescriptorSetLayout;
+        IR_NODISCARD auto update_template() const noexcept -> VkDescriptorUpdateTemplate;
         IR_NODISCARD auto device() const noexcept -> device_t&;
 
         IR_NODISCARD auto bindings() const noexcept -> std::span<const descriptor_binding_t>;
@@ -56,10 +62,18 @@ namespace ir {
         IR_NODISCARD auto index() const noexcept -> uint32;
         IR_NODISCARD auto is_dynamic() const noexcept -> bool;
 
+        IR_NODISCARD auto update_offset(uint32 binding) const noexcept -> uint32;
+        IR_NODISCARD auto update_size() const noexcept -> uint32;
+        IR_NODISCARD auto update_count() const noexcept -> uint32;
+
     private:
         VkDescriptorSetLayout _handle = {};
+        VkDescriptorUpdateTemplate _update_template = {};
 
         std::vector<descriptor_binding_t> _bindings;
+        std::vector<uint32> _update_offsets;
+        uint32 _update_size = 0;
+        uint32 _update_count = 0;
         std::reference_wrapper<device_t> _device;
     };
 
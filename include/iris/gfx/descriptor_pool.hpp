@@ -12,6 +12,7 @@
 #include <spdlog/spdlog.h>
 
 #include <array>
+#include <mutex>
 #include <span>
 #include <string>
 #include <vector>
@@ -44,9 +45,13 @@ namespace ir {
 
         IR_NODISCARD auto capacity(descriptor_type_t) const noexcept -> uint32;
 
+        IR_NODISCARD auto allocate(VkDescriptorSetAllocateInfo& info, VkDescriptorSet& set) const noexcept -> VkResult;
+        auto free(VkDescriptorSet set) const noexcept -> void;
+
     private:
         VkDescriptorPool _handle;
         akl::fast_hash_map<descriptor_type_t, uint32> _sizes;
+        mutable std::mutex _lock;
 
         std::reference_wrapper<device_t> _device;
     };
@@ -19,8 +19,11 @@
 
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace ir {
@@ -38,6 +41,8 @@ namespace ir {
     struct device_create_info_t {
         std::string name = {};
         device_features_t features = {};
+        // every queue submits from its own thread, see queue_create_info_t::threaded
+        bool threaded_submission = false;
     };
 
     struct debug_name_info_t {
@@ -47,7 +52,38 @@ namespace ir {
     };
 
     enum class device_feature_t {
-        e_buffer_device_address
+        e_buffer_device_address,
+        e_memory_budget,
+        // a large device-local heap is host-visible, either resizable BAR or unified memory
+        e_resizable_bar,
+    };
+
+    enum class buffer_placement_t {
+        // device-local memory written through a staging copy
+        e_staged,
+        // host-visible device-local memory written by the CPU directly
+        e_direct,
+    };
+
+    enum class memory_pressure_t {
+        e_none,
+        // device-local heaps are close to their budget, streamers should start dropping detail
+        e_high,
+        // device-local allocations are placed in host memory when they no longer fit
+        e_critical,
+    };
+
+    struct memory_heap_stats_t {
+        uint64 usage = 0;
+        uint64 budget = 0;
+        uint64 allocation_bytes = 0;
+        uint64 block_bytes = 0;
+        bool is_device_local = false;
+    };
+
+    struct memory_stats_t {
+        std::vector<memory_heap_stats_t> heaps;
+        memory_pressure_t pressure = memory_pressure_t::e_none;
     };
 
     class device_t : public enable_intrusive_refcount_t<device_t> {
@@ -80,11 +116,15 @@ namespace ir {
         IR_NODISCARD auto transfer_queue() noexcept -> queue_t&;
         IR_NODISCARD auto transfer_queue() const noexcept -> const queue_t&;
 
-        IR_NODISCARD auto descriptor_pool() const noexcept -> const descriptor_pool_t&;
+        IR_NODISCARD auto descriptor_pool() const noexcept -> arc_ptr<const descriptor_pool_t>;
+        IR_NODISCARD auto upload_ring() noexcept -> upload_ring_t&;
+        IR_NODISCARD auto upload_service() noexcept -> upload_service_t&;
 
         IR_NODISCARD auto frame_counter() noexcept -> master_frame_counter_t&;
         IR_NODISCARD auto frame_counter() const noexcept -> const master_frame_counter_t&;
-        IR_NODISCARD auto deletion_queue() noexcept -> deletion_queue_t&;
+        IR_NODISCARD auto deletion_queue() const noexcept -> deletion_queue_t&;
+        IR_NODISCARD auto defragmenter() const noexcept -> defragmenter_t&;
+        IR_NODISCARD auto resource_pool() const noexcept -> resource_pool_t&;
 
         IR_NODISCARD auto info() const noexcept -> const device_create_info_t&;
         IR_NODISCARD auto instance() const noexcept -> const instance_t&;
@@ -97,16 +137,29 @@ namespace ir {
 
         auto wait_idle() const noexcept -> void;
 
-        auto resize_descriptor_pool(const akl::fast_hash_map<descriptor_type_t, uint32>& size) noexcept -> void;
+        auto resize_descriptor_pool(
+            const descriptor_pool_t& exhausted,
+            const akl::fast_hash_map<descriptor_type_t, uint32>& size
+        ) noexcept -> void;
 
         template <typename T>
-        IR_NODISCARD auto cache() noexcept -> cache_t<T>&;
+        IR_NODISCARD auto cache() noexcept -> concurrent_cache_t<T>&;
 
         IR_NODISCARD auto is_supported(device_feature_t feature) const noexcept -> bool;
 
+        // refreshed every tick()
+        IR_NODISCARD auto memory_stats() const noexcept -> memory_stats_t;
+        IR_NODISCARD auto memory_pressure() const noexcept -> memory_pressure_t;
+        // invoked from tick() whenever the pressure level changes
+        auto on_memory_pressure(std::function<void(memory_pressure_t)> callback) noexcept -> void;
+        // direct while the buffer is small enough and the host-visible device-local heap has budget left
+        IR_NODISCARD auto buffer_placement(uint64 bytes) const noexcept -> buffer_placement_t;
+
         auto tick() noexcept -> void;
 
     private:
+        auto _refresh_memory_stats() noexcept -> void;
+
         VkDevice _handle = {};
         VkPhysicalDevice _gpu = {};
         VmaAllocator _allocator = {};
@@ -128,13 +181,26 @@ namespace ir {
         arc_ptr<queue_t> _transfer;
 
         arc_ptr<descriptor_pool_t> _descriptor_pool;
+        mutable std::mutex _descriptor_pool_lock;
 
-        arc_ptr<master_frame_counter_t> _frame_counter;
-        deletion_queue_t _deletion_queue;
+        arc_ptr<upload_ring_t> _upload_ring;
+        arc_ptr<upload_service_t> _upload_service;
 
-        cache_t<descriptor_layout_t> _descriptor_layouts;
-        cache_t<descriptor_set_t> _descriptor_sets;
-        cache_t<sampler_t> _samplers;
+        arc_ptr<master_frame_counter_t> _frame_counter;
+        arc_ptr<deletion_queue_t> _deletion_queue;
+        arc_ptr<defragmenter_t> _defragmenter;
+        arc_ptr<resource_pool_t> _resource_pool;
+
+        concurrent_cache_t<descriptor_layout_t> _descriptor_layouts;
+        concurrent_cache_t<descriptor_set_t> _descriptor_sets;
+        concurrent_cache_t<sampler_t> _samplers;
+
+        bool _is_memory_budget_enabled = false;
+        uint32 _rebar_heap = -1_u32;
+        memory_stats_t _memory_stats = {};
+        std::atomic<memory_pressure_t> _memory_pressure = memory_pressure_t::e_none;
+        std::vector<std::function<void(memory_pressure_t)>> _memory_pressure_callbacks;
+        mutable std::mutex _memory_stats_lock;
 
         device_create_info_t _info = {};
         arc_ptr<const instance_t> _instance;
@@ -11,6 +11,7 @@
 
 #include <spdlog/spdlog.h>
 
+#include <functional>
 #include <optional>
 #include <string>
 #include <vector>
@@ -22,7 +23,7 @@ namespace ir {
     public:
         using self = fence_t;
 
-        fence_t() noexcept;
+        fence_t(const device_t& device) noexcept;
         ~fence_t() noexcept;
 
         IR_NODISCARD static auto make(
@@ -48,6 +49,6 @@ namespace ir {
     private:
         VkFence _handle = {};
 
-        arc_ptr<const device_t> _device;
+        std::reference_wrapper<const device_t> _device;
     };
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/enums.hpp>
+#include <iris/core/types.hpp>
+
+#include <iris/gfx/buffer.hpp>
+#include <iris/gfx/deletion_queue.hpp>
+
+#include <volk.h>
+#include <vulkan/vulkan.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <string>
+
+namespace ir {
+    struct frame_allocator_create_info_t {
+        std::string name = {};
+        buffer_usage_t usage =
+            buffer_usage_t::e_uniform_buffer |
+            buffer_usage_t::e_storage_buffer |
+            buffer_usage_t::e_indirect_buffer;
+        // bytes available to a single frame
+        uint64 capacity = 4_MiB;
+        // a region is only rewound once its frame has retired, fewer regions than frames in flight alias live data
+        uint32 frames_in_flight = static_cast<uint32>(deletion_queue_t::frames_in_flight);
+    };
+
+    struct frame_allocation_t {
+        buffer_info_t slice = {};
+        uint8* data = nullptr;
+        uint64 address = 0;
+    };
+
+    // bump allocator over one mapped buffer split into a region per frame in flight. a region is
+    // rewound the first time it is used by a new frame, by then the frame that last used it has retired
+    class frame_allocator_t : public enable_intrusive_refcount_t<frame_allocator_t> {
+    public:
+        using self = frame_allocator_t;
+
+        frame_allocator_t(device_t& device) noexcept;
+        ~frame_allocator_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device, const frame_allocator_create_info_t& info = {}) noexcept -> arc_ptr<self>;
+
+        IR_NODISCARD auto buffer() const noexcept -> const buffer_t<uint8>&;
+        IR_NODISCARD auto used() const noexcept -> uint64;
+        IR_NODISCARD auto info() const noexcept -> const frame_allocator_create_info_t&;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+        // alignment: 0 uses the device uniform and storage buffer offset alignment
+        IR_NODISCARD auto allocate(uint64 size, uint64 alignment = 0) noexcept -> frame_allocation_t;
+        template <typename T>
+        IR_NODISCARD auto allocate(std::span<const T> values) noexcept -> frame_allocation_t;
+        template <typename T>
+        IR_NODISCARD auto allocate(const T& value) noexcept -> frame_allocation_t;
+
+    private:
+        auto _rewind() noexcept -> void;
+
+        arc_ptr<buffer_t<uint8>> _buffer;
+        uint64 _alignment = 0;
+        uint64 _frame = -1_u64;
+        uint64 _region = 0;
+        uint64 _head = 0;
+        std::mutex _lock;
+
+        frame_allocator_create_info_t _info = {};
+        std::reference_wrapper<device_t> _device;
+    };
+
+    template <typename T>
+    auto frame_allocator_t::allocate(std::span<const T> values) noexcept -> frame_allocation_t {
+        IR_PROFILE_SCOPED();
+        auto allocation = allocate(values.size_bytes(), std::max<uint64>(alignof(T), _alignment));
+        std::memcpy(allocation.data, values.data(), values.size_bytes());
+        return allocation;
+    }
+
+    template <typename T>
+    auto frame_allocator_t::allocate(const T& value) noexcept -> frame_allocation_t {
+        IR_PROFILE_SCOPED();
+        return allocate(std::span<const T>(&value, 1));
+    }
+}
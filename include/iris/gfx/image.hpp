@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iris/core/forwards.hpp>
+#include <iris/core/hash.hpp>
 #include <iris/core/intrusive_atomic_ptr.hpp>
 #include <iris/core/macros.hpp>
 #include <iris/core/enums.hpp>
@@ -18,19 +19,35 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
 
 namespace ir {
     struct image_subresource_t {
+        constexpr auto operator ==(const image_subresource_t& other) const noexcept -> bool = default;
+
         uint32 level = level_ignored;
         uint32 level_count = remaining_levels;
         uint32 layer = layer_ignored;
         uint32 layer_count = remaining_layers;
     };
 
+    // last use of an image subresource, as left behind by the barriers recorded on it
+    struct image_state_t {
+        constexpr auto operator ==(const image_state_t& other) const noexcept -> bool = default;
+
+        pipeline_stage_t stage = pipeline_stage_t::e_none;
+        resource_access_t access = resource_access_t::e_none;
+        image_layout_t layout = image_layout_t::e_undefined;
+    };
+
     struct image_view_create_info_t {
+        auto operator ==(const image_view_create_info_t& other) const noexcept -> bool = default;
+
         std::string name = {};
         resource_format_t format = resource_format_t::e_undefined;
-        struct {
+        struct swizzle_t {
+            constexpr auto operator ==(const swizzle_t& other) const noexcept -> bool = default;
+
             component_swizzle_t r = component_swizzle_t::e_identity;
             component_swizzle_t g = component_swizzle_t::e_identity;
             component_swizzle_t b = component_swizzle_t::e_identity;
@@ -42,6 +59,8 @@ namespace ir {
     const static auto default_image_view_info = image_view_create_info_t();
 
     struct image_create_info_t {
+        auto operator ==(const image_create_info_t& other) const noexcept -> bool = default;
+
         std::string name = {};
         uint32 width = 0;
         uint32 height = 0;
@@ -53,6 +72,10 @@ namespace ir {
         image_flag_t flags = {};
         resource_format_t format = resource_format_t::e_undefined;
         image_layout_t layout = image_layout_t::e_undefined;
+        // the defragmenter may relocate the image, handle() and view().handle() change after a pass while view()
+        // stays the same object, other views and framebuffers are remade in on_relocation. subresources keep their
+        // tracked state, untracked ones have undefined contents and are not preserved
+        bool movable = false;
         std::optional<image_view_create_info_t> view = std::nullopt;
     };
 
@@ -75,12 +98,19 @@ namespace ir {
         IR_NODISCARD auto device() const noexcept -> const device_t&;
 
     private:
+        friend class image_t;
+
+        // remakes the handle over the image's current one, the view object itself stays
+        auto _relocate() noexcept -> void;
+
         VkImageView _handle = {};
         image_aspect_t _aspect = {};
 
         image_view_create_info_t _info = {};
         std::reference_wrapper<const image_t> _image;
-        arc_ptr<const device_t> _device = {};
+        const device_t* _device = nullptr;
+        // dropped while the image is pooled, see image_t::_pin
+        arc_ptr<const device_t> _device_pin = {};
     };
 
     class image_t : public enable_intrusive_refcount_t<image_t> {
@@ -107,6 +137,19 @@ namespace ir {
             const image_create_info_t& info
         ) noexcept -> arc_ptr<self>;
 
+        // binds the image at offset within memory it does not own, the memory must outlive the image
+        IR_NODISCARD static auto make_aliased(
+            const device_t& device,
+            VmaAllocation memory,
+            uint64 offset,
+            const image_create_info_t& info
+        ) noexcept -> arc_ptr<self>;
+
+        IR_NODISCARD static auto query_memory_requirements(
+            const device_t& device,
+            const image_create_info_t& info
+        ) noexcept -> VkMemoryRequirements;
+
         IR_NODISCARD auto handle() const noexcept -> VkImage;
         IR_NODISCARD auto memory_requirements() const noexcept -> const VkMemoryRequirements&;
         IR_NODISCARD auto sparse_requirements() const noexcept -> const VkSparseImageMemoryRequirements&;
@@ -125,18 +168,37 @@ namespace ir {
         IR_NODISCARD auto format() const noexcept -> resource_format_t;
         IR_NODISCARD auto layout() const noexcept -> image_layout_t;
 
+        // explicit level and layer ranges, ignored and remaining counts resolved against the image
+        IR_NODISCARD auto resolve(const image_subresource_t& subresource) const noexcept -> image_subresource_t;
+        // tracked in recording order, recorders sharing an image must order their recording like their submissions
+        IR_NODISCARD auto state(uint32 level = 0, uint32 layer = 0) const noexcept -> image_state_t;
+        // records a state reached without a barrier, e.g. render pass final layouts or presentation
+        auto track(const image_state_t& state, const image_subresource_t& subresource = {}) const noexcept -> void;
+
         IR_NODISCARD auto info() const noexcept -> const image_create_info_t&;
         IR_NODISCARD auto device() const noexcept -> const device_t&;
 
     private:
+        friend class resource_pool_t;
+
+        IR_NODISCARD auto _is_movable() const noexcept -> bool;
+        auto _relocate(command_buffer_t& command_buffer, VmaAllocation allocation) noexcept -> bool;
+        // pooled images must not keep the device alive, the device owns the resource pool
+        auto _pin(bool is_pinned) noexcept -> void;
+
         VkImage _handle = {};
         VkMemoryRequirements _requirements = {};
         VkSparseImageMemoryRequirements _sparse_info = {};
         VmaAllocation _allocation = {};
+        bool _is_aliased = false;
         arc_ptr<image_view_t> _view;
+        // one per level and layer, layer major, empty until the first barrier
+        mutable std::vector<image_state_t> _states;
+        mutable std::mutex _state_lock;
 
         image_create_info_t _info = {};
-        arc_ptr<const device_t> _device = {};
+        const device_t* _device = nullptr;
+        arc_ptr<const device_t> _device_pin = {};
     };
 
     class virtual_image_t : enable_intrusive_refcount_t<virtual_image_t> {
@@ -151,3 +213,22 @@ namespace ir {
         arc_ptr<image_t> _handle;
     };
 }
+
+IR_MAKE_TRANSPARENT_EQUAL_TO_SPECIALIZATION(ir::image_create_info_t);
+
+IR_MAKE_AVALANCHING_TRANSPARENT_HASH_SPECIALIZATION(ir::image_create_info_t, ([](const auto& x) -> std::size_t {
+    IR_PROFILE_SCOPED();
+    auto seed = std::size_t();
+    seed = ir::akl::hash<std::string>()(x.name);
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::uint32>()(x.width));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::uint32>()(x.height));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::uint32>()(x.levels));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::uint32>()(x.layers));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::image_usage_t>()(x.usage));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::resource_format_t>()(x.format));
+    seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::image_layout_t>()(x.layout));
+    if (x.view) {
+        seed = ir::akl::wyhash::mix(seed, ir::akl::hash<ir::resource_format_t>()(x.view->format));
+    }
+    return seed;
+}));
@@ -111,6 +111,8 @@ namespace ir {
         IR_NODISCARD auto compute_info() const noexcept -> const compute_pipeline_create_info_t&;
         IR_NODISCARD auto graphics_info() const noexcept -> const graphics_pipeline_create_info_t&;
         IR_NODISCARD auto mesh_info() const noexcept -> const mesh_shading_pipeline_create_info_t&;
+        // empty for compute pipelines
+        IR_NODISCARD auto dynamic_states() const noexcept -> std::span<const dynamic_state_t>;
         IR_NODISCARD auto device() noexcept -> device_t&;
         IR_NODISCARD auto render_pass() const noexcept -> const render_pass_t&;
 
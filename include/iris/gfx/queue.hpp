@@ -1,9 +1,11 @@
 #pragma once
 
 #include <iris/core/forwards.hpp>
+#include <iris/core/hash.hpp>
 #include <iris/core/intrusive_atomic_ptr.hpp>
 #include <iris/core/enums.hpp>
 #include <iris/core/macros.hpp>
+#include <iris/core/mpsc_queue.hpp>
 #include <iris/core/types.hpp>
 
 #include <volk.h>
@@ -11,9 +13,13 @@
 
 #include <spdlog/spdlog.h>
 
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 
 namespace ir {
     struct queue_family_t {
@@ -43,10 +49,29 @@ namespace ir {
         std::vector<sparse_image_memory_bind_t> bindings;
     };
 
+    struct sparse_memory_bind_t {
+        // byte range of the resource, a null buffer.memory unbinds it
+        uint64 offset = 0;
+        uint64 size = 0;
+        buffer_info_t buffer = {};
+    };
+
+    struct sparse_buffer_memory_bind_info_t {
+        VkBuffer buffer = {};
+        std::vector<sparse_memory_bind_t> bindings;
+    };
+
+    struct sparse_image_opaque_memory_bind_info_t {
+        std::reference_wrapper<const image_t> image;
+        std::vector<sparse_memory_bind_t> bindings;
+    };
+
     struct queue_create_info_t {
         std::string name = {};
         queue_family_t family = {};
         queue_type_t type = {};
+        // submit(), defer(), flush() and present() hand their work to a dedicated thread and return right away
+        bool threaded = false;
     };
 
     struct queue_semaphore_stage_t {
@@ -70,9 +95,19 @@ namespace ir {
     struct queue_bind_sparse_info_t {
         std::vector<queue_semaphore_stage_t> wait_semaphores;
         std::vector<queue_semaphore_stage_t> signal_semaphores;
+        std::vector<sparse_buffer_memory_bind_info_t> buffer_binds;
+        std::vector<sparse_image_opaque_memory_bind_info_t> image_opaque_binds;
         std::vector<sparse_image_memory_bind_info_t> image_binds;
     };
 
+    // transient pool indices bound to threads other than the queue's owner, shared with the threads holding them
+    struct queue_thread_pools_t {
+        // indices of exited threads, handed to the next thread that binds
+        std::vector<uint32> free;
+        uint32 count = 0;
+        std::mutex lock;
+    };
+
     class queue_t : public enable_intrusive_refcount_t<queue_t> {
     public:
         using self = queue_t;
@@ -87,23 +122,108 @@ namespace ir {
         IR_NODISCARD auto index() const noexcept -> uint32;
         IR_NODISCARD auto type() const noexcept -> queue_type_t;
 
+        // deprecated, the index must be the calling thread's own, see transient_pool()
         IR_NODISCARD auto transient_pool(uint32 index) noexcept -> command_pool_t&;
+        // the calling thread's pool, the thread that made the queue gets index 0,
+        // other threads give their index back when they exit
+        IR_NODISCARD auto transient_pool() noexcept -> command_pool_t&;
 
         IR_NODISCARD auto info() const noexcept -> const queue_create_info_t&;
         IR_NODISCARD auto device() const noexcept -> const device_t&;
         IR_NODISCARD auto logger() const noexcept -> spdlog::logger&;
 
+        // flushes deferred submissions in the same call, they stay ahead of this one
         auto submit(const queue_submit_info_t& info, const fence_t* fence = nullptr) noexcept -> void;
+        // kept until flush(), which submits everything deferred so far in one vkQueueSubmit2
+        auto defer(const queue_submit_info_t& info) noexcept -> void;
+        // the fence is signaled once every flushed submission has completed
+        auto flush(const fence_t* fence = nullptr) noexcept -> void;
+        // records and waits on a recycled command buffer and fence, no vulkan objects are created after warmup
         auto submit(const std::function<void(command_buffer_t&)>& record) noexcept -> void;
+        // threaded queues report whether a present completed since the last call found the swapchain out of date
         auto present(const queue_present_info_t& info) noexcept -> bool;
         auto bind_sparse(const queue_bind_sparse_info_t& info, const fence_t* fence = nullptr) noexcept -> void;
         auto wait_idle() noexcept -> void;
 
+        IR_NODISCARD auto is_threaded() const noexcept -> bool;
+        // threaded queues only, reaches timeline_value() once the last flush or present pushed so far has completed,
+        // work deferred after it is only covered by the next one
+        IR_NODISCARD auto timeline() const noexcept -> const semaphore_t&;
+        IR_NODISCARD auto timeline_value() const noexcept -> uint64;
+        // blocks until the submit thread has handed everything pushed so far to the driver, no-op otherwise
+        auto drain() noexcept -> void;
+
     private:
+        struct one_shot_t {
+            arc_ptr<command_buffer_t> command_buffer;
+            arc_ptr<fence_t> fence;
+        };
+
+        IR_NODISCARD auto _thread_index() noexcept -> uint32;
+        IR_NODISCARD auto _transient_pool(uint32 index) noexcept -> command_pool_t&;
+        IR_NODISCARD auto _acquire_one_shot(uint32 index) noexcept -> one_shot_t;
+        auto _release_one_shot(uint32 index, one_shot_t one_shot) noexcept -> void;
+        // both require _deferred_lock
+        auto _append(const queue_submit_info_t& info) noexcept -> void;
+        auto _flush(const fence_t* fence) noexcept -> void;
+        IR_NODISCARD auto _present(const queue_present_info_t& info) noexcept -> bool;
+        // drains the submit thread and flushes what it left deferred
+        auto _settle() noexcept -> void;
+
+        struct work_t {
+            // appended to the deferred submissions
+            std::optional<queue_submit_info_t> submit;
+            bool is_flush = false;
+            const fence_t* fence = nullptr;
+            std::optional<queue_present_info_t> present;
+            // signaled on the timeline by a flush or present
+            uint64 value = 0;
+        };
+
+        auto _push(work_t work) noexcept -> void;
+        auto _process(const work_t& work) noexcept -> void;
+        auto _work() noexcept -> void;
+
         VkQueue _handle = {};
         std::mutex _lock;
 
+        struct deferred_submit_t {
+            uint32 first_wait = 0;
+            uint32 wait_count = 0;
+            uint32 first_command_buffer = 0;
+            uint32 command_buffer_count = 0;
+            uint32 first_signal = 0;
+            uint32 signal_count = 0;
+        };
+
+        // flattened so the storage is reused from frame to frame, taken before _lock
+        std::vector<deferred_submit_t> _deferred;
+        std::vector<VkSemaphoreSubmitInfo> _deferred_waits;
+        std::vector<VkSemaphoreSubmitInfo> _deferred_signals;
+        std::vector<VkCommandBufferSubmitInfo> _deferred_command_buffers;
+        std::vector<VkSubmitInfo2> _submit_infos;
+        std::mutex _deferred_lock;
+
+        // counted before the push, the submit thread pops in push order
+        mpsc_queue_t<work_t> _works;
+        std::atomic<uint64> _reserved = 0;
+        // bumped after the push, the submit thread sleeps on it
+        std::atomic<uint64> _pushed = 0;
+        std::atomic<uint64> _processed = 0;
+        // timeline value of the last pushed flush or present
+        std::atomic<uint64> _flushed = 0;
+        std::mutex _flush_lock;
+        std::atomic<bool> _is_running = true;
+        std::atomic<bool> _is_outdated = false;
+        arc_ptr<semaphore_t> _timeline;
+        std::thread _submit_thread;
+
         std::vector<arc_ptr<command_pool_t>> _transient_pools;
+        std::shared_ptr<queue_thread_pools_t> _thread_pools;
+        // idle one-shot submissions, indexed like the transient pools
+        std::vector<std::vector<one_shot_t>> _one_shots;
+        std::thread::id _owner;
+        std::mutex _pool_lock;
 
         queue_create_info_t _info = {};
         std::shared_ptr<spdlog::logger> _logger;
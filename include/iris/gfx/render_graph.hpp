@@ -0,0 +1,230 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/enums.hpp>
+#include <iris/core/types.hpp>
+
+#include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/descriptor_set.hpp>
+#include <iris/gfx/image.hpp>
+#include <iris/gfx/queue.hpp>
+#include <iris/gfx/transient_allocator.hpp>
+
+#include <volk.h>
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace ir {
+    struct render_graph_create_info_t {
+        std::string name = {};
+    };
+
+    struct render_graph_resource_t {
+        constexpr auto operator ==(const render_graph_resource_t& other) const noexcept -> bool = default;
+
+        uint32 index = -1_u32;
+    };
+
+    struct render_graph_usage_t {
+        pipeline_stage_t stage = pipeline_stage_t::e_none;
+        resource_access_t access = resource_access_t::e_none;
+        // images only
+        image_layout_t layout = image_layout_t::e_undefined;
+    };
+
+    struct render_graph_pass_info_t {
+        std::string name = {};
+        // compute passes run on the async compute queue when the device has one
+        queue_type_t queue = queue_type_t::e_graphics;
+        // kept even when nothing reads its results
+        bool is_side_effect = false;
+        // async compute only, may overlap the rest of the frame's graphics work: the frame only waits on it where
+        // it consumes its results, the next frame's first graphics submission waits on the rest
+        bool is_detached = false;
+    };
+
+    struct render_graph_execute_info_t {
+        // waited on by the first graphics submission
+        std::vector<queue_semaphore_stage_t> wait_semaphores;
+        // signaled by the last graphics submission, after every pass of the frame
+        std::vector<queue_semaphore_stage_t> signal_semaphores;
+        const fence_t* fence = nullptr;
+    };
+
+    struct render_graph_stats_t {
+        uint32 passes = 0;
+        uint32 culled = 0;
+        uint32 async = 0;
+        uint32 detached = 0;
+        uint32 submissions = 0;
+        uint32 barriers = 0;
+    };
+
+    class render_graph_builder_t {
+    public:
+        using self = render_graph_builder_t;
+
+        render_graph_builder_t(render_graph_t& graph, uint32 pass) noexcept;
+
+        auto read(render_graph_resource_t resource, const render_graph_usage_t& usage) noexcept -> self&;
+        auto write(render_graph_resource_t resource, const render_graph_usage_t& usage) noexcept -> self&;
+
+    private:
+        std::reference_wrapper<render_graph_t> _graph;
+        uint32 _pass = 0;
+    };
+
+    // records a frame from passes that declare what they read and write, rebuilt every frame:
+    // add resources and passes, compile() once, then execute()
+    class render_graph_t : public enable_intrusive_refcount_t<render_graph_t> {
+    public:
+        using self = render_graph_t;
+        using setup_function_t = std::function<void(render_graph_builder_t&)>;
+        using execute_function_t = std::function<void(command_buffer_t&)>;
+
+        render_graph_t(device_t& device) noexcept;
+        ~render_graph_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device, const render_graph_create_info_t& info = {}) noexcept -> arc_ptr<self>;
+
+        // initial is the state the image is in when the frame starts, a final layout transitions it at the end
+        IR_NODISCARD auto import_image(const image_t& image, const render_graph_usage_t& initial, const render_graph_usage_t& final = {}) noexcept -> render_graph_resource_t;
+        IR_NODISCARD auto import_buffer(const buffer_info_t& buffer, const render_graph_usage_t& initial = {}) noexcept -> render_graph_resource_t;
+        // transient resources live for one frame and share memory when their lifetimes do not overlap
+        IR_NODISCARD auto create_image(const image_create_info_t& info) noexcept -> render_graph_resource_t;
+        IR_NODISCARD auto create_buffer(const transient_buffer_create_info_t& info) noexcept -> render_graph_resource_t;
+
+        auto add_pass(const render_graph_pass_info_t& info, const setup_function_t& setup, execute_function_t execute) noexcept -> void;
+
+        // culls unused passes, places transient resources, computes barriers and splits the frame into submissions
+        auto compile() noexcept -> void;
+        auto execute(const render_graph_execute_info_t& info = {}) noexcept -> void;
+        // drops every pass and resource, transient memory is kept when the next frame declares the same resources
+        auto reset() noexcept -> void;
+
+        IR_NODISCARD auto image(render_graph_resource_t resource) const noexcept -> const image_t&;
+        IR_NODISCARD auto buffer(render_graph_resource_t resource) const noexcept -> buffer_info_t;
+
+        IR_NODISCARD auto stats() const noexcept -> const render_graph_stats_t&;
+        IR_NODISCARD auto info() const noexcept -> const render_graph_create_info_t&;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+    private:
+        friend class render_graph_builder_t;
+
+        // queue slots
+        constexpr static auto graphics_slot = 0_u32;
+        constexpr static auto compute_slot = 1_u32;
+        constexpr static auto slot_count = 2_u32;
+
+        struct access_t {
+            uint32 resource = 0;
+            render_graph_usage_t usage = {};
+            bool is_write = false;
+        };
+
+        struct resource_t {
+            std::variant<image_create_info_t, transient_buffer_create_info_t> info;
+            const image_t* image = nullptr;
+            buffer_info_t buffer = {};
+            bool is_image = false;
+            bool is_transient = false;
+            render_graph_usage_t initial = {};
+            render_graph_usage_t final = {};
+            uint32 family = queue_family_ignored;
+
+            transient_resource_t transient = {};
+            transient_lifetime_t lifetime = { -1_u32, 0 };
+            bool is_async = false;
+        };
+
+        struct state_t {
+            pipeline_stage_t write_stage = pipeline_stage_t::e_none;
+            resource_access_t write_access = resource_access_t::e_none;
+            // reads since the last write
+            pipeline_stage_t read_stage = pipeline_stage_t::e_none;
+            resource_access_t read_access = resource_access_t::e_none;
+            image_layout_t layout = image_layout_t::e_undefined;
+            uint32 family = queue_family_ignored;
+            uint32 writer = -1_u32;
+            std::array<uint32, slot_count> readers = { -1_u32, -1_u32 };
+        };
+
+        struct pass_t {
+            render_graph_pass_info_t info = {};
+            std::vector<access_t> accesses;
+            execute_function_t execute;
+            bool is_alive = false;
+            uint32 slot = graphics_slot;
+            uint32 batch = -1_u32;
+            barrier_batch_t before;
+            // ownership releases to the other queue
+            barrier_batch_t after;
+        };
+
+        struct batch_t {
+            uint32 slot = graphics_slot;
+            std::vector<uint32> passes;
+            // timeline values of the other queue waited on before the batch starts
+            std::array<uint64, slot_count> waits = {};
+            uint64 signal = 0;
+            bool is_closed = false;
+        };
+
+        auto _cull() noexcept -> void;
+        auto _place() noexcept -> void;
+        auto _schedule() noexcept -> void;
+        auto _use(state_t& state, const resource_t& resource, const access_t& access, uint32 pass, uint32 slot, barrier_batch_t& barriers) noexcept -> void;
+        auto _depend(const state_t& state, bool is_write, uint32 slot) noexcept -> void;
+        IR_NODISCARD auto _last(const state_t& state, uint32 slot) const noexcept -> uint32;
+        auto _open(uint32 slot) noexcept -> batch_t&;
+        auto _close(uint32 slot) noexcept -> void;
+        auto _release(state_t& state, const resource_t& resource, uint32 producer) noexcept -> void;
+        IR_NODISCARD auto _family(uint32 slot) const noexcept -> uint32;
+        IR_NODISCARD auto _queue(uint32 slot) const noexcept -> queue_t&;
+        IR_NODISCARD auto _command_buffer(uint32 slot) noexcept -> command_buffer_t&;
+
+        std::vector<resource_t> _resources;
+        std::vector<pass_t> _passes;
+        std::vector<batch_t> _batches;
+        std::array<uint32, slot_count> _open_batches = { -1_u32, -1_u32 };
+        // batch indices in the order they are submitted
+        std::vector<uint32> _submissions;
+        barrier_batch_t _tail;
+        // ownership acquires of images left on the compute queue by detached passes, made by the next frame
+        barrier_batch_t _acquires;
+        barrier_batch_t _pending;
+        uint64 _pending_value = 0;
+        // async compute touches transient memory or imported resources the previous frame may have used on
+        // another queue, it must not overtake the previous frame's graphics work
+        bool _is_async_shared = false;
+        bool _is_compiled = false;
+
+        arc_ptr<transient_allocator_t> _transient;
+        // declarations backing the compiled transient allocator, reused while unchanged
+        std::vector<std::pair<std::variant<image_create_info_t, transient_buffer_create_info_t>, transient_lifetime_t>> _declarations;
+
+        std::array<arc_ptr<semaphore_t>, slot_count> _timelines;
+        // last value submitted on each timeline, batch signals and waits are relative to it until execute()
+        std::array<uint64, slot_count> _values = {};
+        std::array<uint64, slot_count> _counts = {};
+        // timeline values the command buffers of each frame in flight complete at
+        std::vector<std::array<uint64, slot_count>> _frame_values;
+        // one pool per queue and frame in flight, reset when the frame slot comes around again
+        std::vector<std::array<arc_ptr<command_pool_t>, slot_count>> _pools;
+        std::vector<std::array<std::vector<arc_ptr<command_buffer_t>>, slot_count>> _command_buffers;
+        std::array<uint32, slot_count> _used = {};
+        uint64 _frame = -1_u64;
+
+        render_graph_stats_t _stats = {};
+        render_graph_create_info_t _info = {};
+        std::reference_wrapper<device_t> _device;
+    };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/hash.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/types.hpp>
+
+#include <iris/gfx/buffer.hpp>
+#include <iris/gfx/image.hpp>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace ir {
+    struct resource_pool_stats_t {
+        uint64 hits = 0;
+        uint64 misses = 0;
+        uint64 pooled = 0;
+        uint64 trimmed = 0;
+    };
+
+    // recycles released buffers and images keyed by their create info, acquire() after warmup never allocates
+    class resource_pool_t : public enable_intrusive_refcount_t<resource_pool_t> {
+    public:
+        using self = resource_pool_t;
+
+        // frames a released resource may stay unused before it is destroyed
+        constexpr static auto idle_frames = 240_u64;
+
+        resource_pool_t(device_t& device) noexcept;
+        ~resource_pool_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device) noexcept -> arc_ptr<self>;
+
+        // recycled images keep the layout they were released in, transition from undefined before use
+        IR_NODISCARD auto acquire(const image_create_info_t& info) noexcept -> arc_ptr<image_t>;
+        IR_NODISCARD auto acquire(const buffer_create_info_t& info) noexcept -> arc_ptr<buffer_t<uint8>>;
+
+        // the resource becomes available again once every frame that may use it has completed
+        auto release(arc_ptr<image_t> image) noexcept -> void;
+        auto release(arc_ptr<buffer_t<uint8>> buffer) noexcept -> void;
+
+        auto tick() noexcept -> void;
+        // pooled resources do not keep the device alive, the device clears the pool when it is destroyed
+        auto clear() noexcept -> void;
+
+        IR_NODISCARD auto stats() const noexcept -> resource_pool_stats_t;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+    private:
+        template <typename T>
+        struct entry_t {
+            arc_ptr<T> resource;
+            // available from this frame on
+            uint64 frame = 0;
+        };
+
+        template <typename K, typename T>
+        using bucket_map = akl::fast_hash_map<K, std::vector<entry_t<T>>>;
+
+        template <typename K, typename T>
+        auto _acquire(bucket_map<K, T>& buckets, const K& info) noexcept -> arc_ptr<T>;
+        template <typename K, typename T>
+        auto _trim(bucket_map<K, T>& buckets, uint64 frame) noexcept -> void;
+
+        bucket_map<image_create_info_t, image_t> _images;
+        bucket_map<buffer_create_info_t, buffer_t<uint8>> _buffers;
+        resource_pool_stats_t _stats = {};
+        mutable std::mutex _lock;
+
+        std::reference_wrapper<device_t> _device;
+    };
+}
@@ -28,7 +28,7 @@ namespace ir {
     public:
         using self = semaphore_t;
 
-        semaphore_t() noexcept;
+        semaphore_t(const device_t& device) noexcept;
         ~semaphore_t() noexcept;
 
         IR_NODISCARD static auto make(const device_t& device, const semaphore_create_info_t& info) noexcept -> arc_ptr<self>;
@@ -39,6 +39,10 @@ namespace ir {
         IR_NODISCARD auto is_timeline() const noexcept -> bool;
         IR_NODISCARD auto device() const noexcept -> const device_t&;
 
+        // timeline only
+        IR_NODISCARD auto value() const noexcept -> uint64;
+        auto wait(uint64 value, uint64 timeout = -1_u64) const noexcept -> void;
+
         auto increment(uint64 x = 1) noexcept -> uint64;
 
     private:
@@ -46,6 +50,7 @@ namespace ir {
         uint64 _counter = 0;
         bool _is_timeline = false;
 
-        arc_ptr<const device_t> _device;
+        // note: not owning, the device keeps timeline semaphores of its own
+        std::reference_wrapper<const device_t> _device;
     };
 }
\ No newline at end of file
@@ -11,9 +11,11 @@
 
 #include <spdlog/spdlog.h>
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <span>
 
 namespace ir {
@@ -51,15 +53,21 @@ namespace ir {
         IR_NODISCARD auto device() const noexcept -> const device_t&;
         IR_NODISCARD auto wsi() const noexcept -> const wsi_platform_t&;
 
+        // waits for presents still queued on a threaded queue, the swapchain is externally synchronized
         IR_NODISCARD auto acquire_next_image(const semaphore_t& semaphore) const noexcept -> std::pair<uint32, bool>;
 
     private:
+        friend class queue_t;
+
         VkSwapchainKHR _handle = {};
         VkSurfaceKHR _surface = {};
         resource_format_t _format = {};
         uint32 _width = 0;
         uint32 _height = 0;
         std::vector<arc_ptr<image_t>> _images;
+        // taken by acquires and presents, pending presents were pushed to a threaded queue but not yet presented
+        mutable std::mutex _lock;
+        mutable std::atomic<uint32> _pending_presents = 0;
 
         swapchain_create_info_t _info = {};
         std::reference_wrapper<const wsi_platform_t> _wsi;
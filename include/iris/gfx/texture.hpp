@@ -6,6 +6,8 @@
 #include <iris/core/enums.hpp>
 #include <iris/core/types.hpp>
 
+#include <iris/gfx/upload_service.hpp>
+
 #include <volk.h>
 #include <vulkan/vulkan.h>
 
@@ -50,6 +52,8 @@ namespace ir {
         ) noexcept -> arc_ptr<self>;
 
         IR_NODISCARD auto image() const noexcept -> const image_t&;
+        // the image is usable once the upload completes and has been acquired by its queue
+        IR_NODISCARD auto upload() const noexcept -> upload_handle_t;
 
         IR_NODISCARD auto info() const noexcept -> image_info_t;
         IR_NODISCARD auto info(const ir::sampler_t& sampler) const noexcept -> image_info_t;
@@ -57,6 +61,7 @@ namespace ir {
 
     private:
         arc_ptr<const image_t> _image = {};
+        upload_handle_t _upload = {};
 
         texture_create_info_t _info = {};
         arc_ptr<device_t> _device;
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/enums.hpp>
+#include <iris/core/types.hpp>
+
+#include <iris/gfx/descriptor_set.hpp>
+#include <iris/gfx/image.hpp>
+
+#include <volk.h>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <spdlog/spdlog.h>
+
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace ir {
+    struct transient_allocator_create_info_t {
+        std::string name = {};
+    };
+
+    // inclusive range of pass indices within a frame
+    struct transient_lifetime_t {
+        constexpr auto operator ==(const transient_lifetime_t& other) const noexcept -> bool = default;
+
+        uint32 first = 0;
+        uint32 last = 0;
+    };
+
+    struct transient_buffer_create_info_t {
+        auto operator ==(const transient_buffer_create_info_t& other) const noexcept -> bool = default;
+
+        std::string name = {};
+        buffer_usage_t usage = {};
+        // in bytes
+        uint64 size = 0;
+    };
+
+    struct transient_resource_t {
+        constexpr auto operator ==(const transient_resource_t& other) const noexcept -> bool = default;
+
+        uint32 index = -1_u32;
+    };
+
+    struct transient_allocator_stats_t {
+        uint64 resources = 0;
+        // bytes backing every resource after aliasing
+        uint64 allocated = 0;
+        // bytes the same resources would need without aliasing
+        uint64 requested = 0;
+    };
+
+    // places resources with disjoint lifetimes in the same memory, declare everything then compile() once
+    class transient_allocator_t : public enable_intrusive_refcount_t<transient_allocator_t> {
+    public:
+        using self = transient_allocator_t;
+
+        transient_allocator_t(device_t& device) noexcept;
+        ~transient_allocator_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device, const transient_allocator_create_info_t& info = {}) noexcept -> arc_ptr<self>;
+
+        IR_NODISCARD auto declare(const image_create_info_t& info, transient_lifetime_t lifetime) noexcept -> transient_resource_t;
+        IR_NODISCARD auto declare(const transient_buffer_create_info_t& info, transient_lifetime_t lifetime) noexcept -> transient_resource_t;
+
+        // packs the declared resources and creates them, invalidated by reset()
+        auto compile() noexcept -> void;
+        // retires every resource and its memory, declarations must be made again
+        auto reset() noexcept -> void;
+
+        IR_NODISCARD auto image(transient_resource_t resource) const noexcept -> const image_t&;
+        IR_NODISCARD auto buffer(transient_resource_t resource) const noexcept -> buffer_info_t;
+
+        // emits the aliasing barriers and initial transitions for resources whose lifetime starts at pass
+        auto begin_pass(command_buffer_t& command_buffer, uint32 pass) const noexcept -> void;
+
+        IR_NODISCARD auto is_compiled() const noexcept -> bool;
+        IR_NODISCARD auto stats() const noexcept -> transient_allocator_stats_t;
+        IR_NODISCARD auto info() const noexcept -> const transient_allocator_create_info_t&;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+    private:
+        struct resource_t {
+            std::variant<image_create_info_t, transient_buffer_create_info_t> info;
+            transient_lifetime_t lifetime = {};
+            VkMemoryRequirements requirements = {};
+            uint64 offset = 0;
+            // overlaps memory of a resource that died earlier in the frame
+            bool is_aliasing = false;
+
+            arc_ptr<image_t> image;
+            VkBuffer buffer = {};
+            uint64 address = 0;
+        };
+
+        auto _place() noexcept -> uint64;
+
+        std::vector<resource_t> _resources;
+        std::vector<std::vector<uint32>> _starts;
+        VmaAllocation _memory = {};
+        transient_allocator_stats_t _stats = {};
+
+        transient_allocator_create_info_t _info = {};
+        std::reference_wrapper<device_t> _device;
+    };
+}
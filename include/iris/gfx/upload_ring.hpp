@@ -0,0 +1,87 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/types.hpp>
+
+#include <iris/gfx/descriptor_set.hpp>
+
+#include <volk.h>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <spdlog/spdlog.h>
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ir {
+    struct upload_ring_create_info_t {
+        std::string name = {};
+        uint64 capacity = 64_MiB;
+        // larger requests get a dedicated staging buffer instead of a ring slice
+        uint64 spill_threshold = 16_MiB;
+    };
+
+    struct upload_allocation_t {
+        buffer_info_t slice = {};
+        uint8* data = nullptr;
+        uint64 offset = -1_u64;
+        // set when the allocation got a dedicated staging buffer
+        VmaAllocation spill = {};
+    };
+
+    class upload_ring_t : public enable_intrusive_refcount_t<upload_ring_t> {
+    public:
+        using self = upload_ring_t;
+
+        upload_ring_t(device_t& device) noexcept;
+        ~upload_ring_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device, const upload_ring_create_info_t& info = {}) noexcept -> arc_ptr<self>;
+
+        IR_NODISCARD auto handle() const noexcept -> VkBuffer;
+        IR_NODISCARD auto capacity() const noexcept -> uint64;
+        IR_NODISCARD auto timeline() const noexcept -> const semaphore_t&;
+        IR_NODISCARD auto info() const noexcept -> const upload_ring_create_info_t&;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+        // blocks on timeline() when the ring is full and the oldest slice is still in flight
+        IR_NODISCARD auto allocate(uint64 size, uint64 alignment = 16) noexcept -> upload_allocation_t;
+        // value: timeline() value signaled once the GPU is done reading, 0 if already consumed
+        auto release(const upload_allocation_t& allocation, uint64 value = 0) noexcept -> void;
+        // reserves the next timeline() value, submissions must signal them in order
+        IR_NODISCARD auto next_value() noexcept -> uint64;
+
+    private:
+        struct region_t {
+            uint64 offset = 0;
+            uint64 size = 0;
+            uint64 value = 0;
+            bool is_released = false;
+        };
+
+        auto _reclaim(uint64 completed) noexcept -> void;
+        auto _reserve(uint64 size, uint64 alignment) noexcept -> uint64;
+        auto _spill(uint64 size) noexcept -> upload_allocation_t;
+
+        VkBuffer _handle = {};
+        VmaAllocation _allocation = {};
+        VmaAllocationInfo _allocation_info = {};
+        uint8* _data = nullptr;
+        uint64 _address = 0;
+
+        uint64 _head = 0;
+        uint64 _value = 0;
+        std::deque<region_t> _regions;
+        std::mutex _lock;
+
+        arc_ptr<semaphore_t> _timeline;
+
+        upload_ring_create_info_t _info = {};
+        std::reference_wrapper<device_t> _device;
+    };
+}
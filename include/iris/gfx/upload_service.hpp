@@ -0,0 +1,115 @@
+#pragma once
+
+#include <iris/core/forwards.hpp>
+#include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/macros.hpp>
+#include <iris/core/enums.hpp>
+#include <iris/core/hash.hpp>
+#include <iris/core/types.hpp>
+
+#include <iris/gfx/descriptor_set.hpp>
+#include <iris/gfx/upload_ring.hpp>
+#include <iris/gfx/queue.hpp>
+#include <iris/gfx/image.hpp>
+
+#include <volk.h>
+#include <vulkan/vulkan.h>
+
+#include <spdlog/spdlog.h>
+
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace ir {
+    struct upload_handle_t {
+        uint64 value = 0;
+    };
+
+    struct upload_image_region_t {
+        uint64 offset = 0;
+        image_subresource_t subresource = {};
+    };
+
+    struct upload_buffer_info_t {
+        buffer_info_t dest = {};
+        std::span<const uint8> data;
+        // queue that will consume the buffer, ignored for concurrent buffers
+        queue_type_t queue = queue_type_t::e_graphics;
+        bool is_shared = false;
+    };
+
+    struct upload_image_info_t {
+        std::reference_wrapper<const image_t> image;
+        std::span<const uint8> data;
+        std::vector<upload_image_region_t> regions;
+        image_layout_t layout = image_layout_t::e_shader_read_only_optimal;
+    };
+
+    // records copies into a single transfer queue command buffer per batch, each flushed batch signals
+    // the upload ring timeline. resources owned by another queue family must be acquired by their owner
+    class upload_service_t : public enable_intrusive_refcount_t<upload_service_t> {
+    public:
+        using self = upload_service_t;
+
+        constexpr static auto max_batch_size = 32_MiB;
+
+        upload_service_t(device_t& device) noexcept;
+        ~upload_service_t() noexcept;
+
+        IR_NODISCARD static auto make(device_t& device) noexcept -> arc_ptr<self>;
+
+        IR_NODISCARD auto timeline() const noexcept -> const semaphore_t&;
+        IR_NODISCARD auto device() const noexcept -> device_t&;
+
+        auto upload(const upload_buffer_info_t& info) noexcept -> upload_handle_t;
+        auto upload(const upload_image_info_t& info) noexcept -> upload_handle_t;
+        auto flush() noexcept -> upload_handle_t;
+
+        // records pending ownership acquires for the queue family of the command buffer, the returned
+        // wait must be part of the submission that executes it
+        IR_NODISCARD auto acquire(
+            command_buffer_t& command_buffer,
+            pipeline_stage_t stage
+        ) noexcept -> std::optional<queue_semaphore_stage_t>;
+
+        IR_NODISCARD auto is_complete(upload_handle_t handle) const noexcept -> bool;
+        auto wait(upload_handle_t handle) noexcept -> void;
+
+        auto tick() noexcept -> void;
+
+    private:
+        struct pending_acquire_t {
+            arc_ptr<const image_t> image;
+            buffer_info_t buffer = {};
+            image_layout_t layout = image_layout_t::e_undefined;
+            uint32 family = 0;
+        };
+
+        struct batch_t {
+            arc_ptr<command_buffer_t> command_buffer;
+            std::vector<upload_allocation_t> staging;
+            std::vector<pending_acquire_t> acquires;
+            uint64 value = 0;
+            uint64 size = 0;
+        };
+
+        auto _open() noexcept -> batch_t&;
+        auto _submit() noexcept -> void;
+        auto _family(queue_type_t type) const noexcept -> uint32;
+
+        arc_ptr<command_pool_t> _pool;
+        std::optional<batch_t> _batch;
+        std::deque<batch_t> _in_flight;
+        // command buffers of retired batches, re-recorded by the next batch
+        std::vector<arc_ptr<command_buffer_t>> _recycled;
+        std::vector<pending_acquire_t> _acquires;
+        akl::fast_hash_map<uint32, uint64> _acquired;
+        uint64 _submitted = 0;
+        mutable std::mutex _lock;
+
+        std::reference_wrapper<device_t> _device;
+    };
+}
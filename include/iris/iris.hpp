@@ -4,6 +4,8 @@
 #include <iris/core/forwards.hpp>
 #include <iris/core/hash.hpp>
 #include <iris/core/intrusive_atomic_ptr.hpp>
+#include <iris/core/job_system.hpp>
 #include <iris/core/macros.hpp>
+#include <iris/core/mpsc_queue.hpp>
 #include <iris/core/types.hpp>
 #include <iris/core/utilities.hpp>
@@ -0,0 +1,254 @@
+#include <iris/core/job_system.hpp>
+
+#include <algorithm>
+
+namespace ir {
+    struct job_worker_binding_t {
+        const job_system_t* system = nullptr;
+        uint32 index = -1_u32;
+    };
+
+    static thread_local auto current_worker = job_worker_binding_t();
+
+    job_counter_t::job_counter_t() noexcept = default;
+
+    job_counter_t::~job_counter_t() noexcept {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(pending() == 0, "job_counter_t: destroyed with pending jobs");
+    }
+
+    auto job_counter_t::pending() const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        return _pending.load(std::memory_order_acquire);
+    }
+
+    auto job_counter_t::is_done() const noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        return pending() == 0;
+    }
+
+    job_system_t::job_system_t() noexcept = default;
+
+    job_system_t::~job_system_t() noexcept {
+        IR_PROFILE_SCOPED();
+        {
+            auto guard = std::lock_guard(_wake_lock);
+            _is_running = false;
+        }
+        _wake.notify_all();
+        // note: workers drain every queued job before exiting
+        for (auto& worker : _workers) {
+            worker->thread.join();
+        }
+    }
+
+    auto job_system_t::make(const job_system_create_info_t& info) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto system = arc_ptr<self>(new self());
+        auto workers = info.workers;
+        if (workers == 0) {
+            workers = std::max(std::thread::hardware_concurrency(), 2_u32) - 1;
+        }
+        system->_info = info;
+        system->_workers.reserve(workers);
+        for (auto i = 0_u32; i < workers; ++i) {
+            system->_workers.emplace_back(std::make_unique<worker_t>());
+        }
+        // note: threads start once every deque exists, they steal from all of them
+        for (auto i = 0_u32; i < workers; ++i) {
+            system->_workers[i]->thread = std::thread([system = system.get(), i]() {
+                system->_work(i);
+            });
+        }
+        return system;
+    }
+
+    auto job_system_t::worker_index() const noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        if (current_worker.system != this) {
+            return -1_u32;
+        }
+        return current_worker.index;
+    }
+
+    auto job_system_t::worker_count() const noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        return _workers.size();
+    }
+
+    auto job_system_t::info() const noexcept -> const job_system_create_info_t& {
+        IR_PROFILE_SCOPED();
+        return _info;
+    }
+
+    auto job_system_t::spawn(job_function_t function, job_counter_t* counter) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (counter) {
+            counter->_pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        _push({
+            .function = std::move(function),
+            .counter = counter,
+        });
+    }
+
+    auto job_system_t::spawn_after(job_counter_t& dependency, job_function_t function, job_counter_t* counter) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (counter) {
+            counter->_pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            auto guard = std::lock_guard(dependency._lock);
+            if (!dependency.is_done()) {
+                dependency._continuations.emplace_back(job_counter_t::continuation_t {
+                    .function = std::move(function),
+                    .counter = counter,
+                });
+                return;
+            }
+        }
+        _push({
+            .function = std::move(function),
+            .counter = counter,
+        });
+    }
+
+    auto job_system_t::parallel_for(uint32 count, uint32 batch, const std::function<void(uint32, uint32)>& function) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        batch = std::max(batch, 1_u32);
+        auto counter = job_counter_t();
+        for (auto first = 0_u32; first < count; first += batch) {
+            const auto last = std::min(first + batch, count);
+            spawn([&function, first, last]() {
+                function(first, last);
+            }, &counter);
+        }
+        wait(counter);
+    }
+
+    auto job_system_t::wait(const job_counter_t& counter) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto index = worker_index();
+        while (!counter.is_done()) {
+            auto job = job_t();
+            if (_pop(index, job)) {
+                _run(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        // note: the last signal may still hold the lock, the counter must not be destroyed under it
+        auto guard = std::lock_guard(counter._lock);
+    }
+
+    auto job_system_t::_push(job_t job) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto index = worker_index();
+        if (index != -1_u32) {
+            auto& worker = *_workers[index];
+            auto guard = std::lock_guard(worker.lock);
+            worker.jobs.emplace_back(std::move(job));
+        } else {
+            auto guard = std::lock_guard(_injected_lock);
+            _injected.emplace_back(std::move(job));
+        }
+        _queued.fetch_add(1, std::memory_order_release);
+        {
+            auto guard = std::lock_guard(_wake_lock);
+        }
+        _wake.notify_one();
+    }
+
+    auto job_system_t::_pop(uint32 index, job_t& job) noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        if (_queued.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        // note: newest local work first, it is most likely still in cache
+        if (index != -1_u32) {
+            auto& worker = *_workers[index];
+            auto guard = std::lock_guard(worker.lock);
+            if (!worker.jobs.empty()) {
+                job = std::move(worker.jobs.back());
+                worker.jobs.pop_back();
+                _queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        {
+            auto guard = std::lock_guard(_injected_lock);
+            if (!_injected.empty()) {
+                job = std::move(_injected.front());
+                _injected.pop_front();
+                _queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        const auto count = static_cast<uint32>(_workers.size());
+        const auto start = index == -1_u32 ? 0 : index + 1;
+        for (auto i = 0_u32; i < count; ++i) {
+            const auto victim = (start + i) % count;
+            if (victim == index) {
+                continue;
+            }
+            auto& worker = *_workers[victim];
+            auto guard = std::lock_guard(worker.lock);
+            if (!worker.jobs.empty()) {
+                job = std::move(worker.jobs.front());
+                worker.jobs.pop_front();
+                _queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto job_system_t::_run(job_t& job) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        job.function();
+        _signal(job.counter);
+    }
+
+    auto job_system_t::_signal(job_counter_t* counter) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (!counter) {
+            return;
+        }
+        auto continuations = std::vector<job_counter_t::continuation_t>();
+        {
+            auto guard = std::lock_guard(counter->_lock);
+            if (counter->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                continuations = std::move(counter->_continuations);
+                counter->_continuations.clear();
+            }
+        }
+        for (auto& continuation : continuations) {
+            _push({
+                .function = std::move(continuation.function),
+                .counter = continuation.counter,
+            });
+        }
+    }
+
+    auto job_system_t::_work(uint32 index) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        current_worker = {
+            .system = this,
+            .index = index,
+        };
+        while (true) {
+            auto job = job_t();
+            if (_pop(index, job)) {
+                _run(job);
+                continue;
+            }
+            auto lock = std::unique_lock(_wake_lock);
+            if (!_is_running && _queued.load(std::memory_order_acquire) == 0) {
+                break;
+            }
+            _wake.wait(lock, [this]() {
+                return _queued.load(std::memory_order_acquire) != 0 || !_is_running;
+            });
+        }
+    }
+}
@@ -0,0 +1,190 @@
+#include <iris/gfx/device.hpp>
+#include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/descriptor_set.hpp>
+#include <iris/gfx/pipeline.hpp>
+#include <iris/gfx/sampler.hpp>
+#include <iris/gfx/async_compute.hpp>
+
+#include <algorithm>
+
+namespace ir {
+    struct reduce_constants_t {
+        uint32 width = 0;
+        uint32 height = 0;
+    };
+
+    async_compute_t::async_compute_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    async_compute_t::~async_compute_t() noexcept = default;
+
+    auto async_compute_t::make(device_t& device, const async_compute_create_info_t& info) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto compute = arc_ptr<self>(new self(device));
+        if (!info.hiz_reduce.empty()) {
+            compute->_hiz_reduce = pipeline_t::make(device, compute_pipeline_create_info_t {
+                .name = info.name + "_hiz_reduce",
+                .compute = info.hiz_reduce,
+            });
+            // note: texel centers of the previous level are sampled, a min reduction keeps the hierarchy conservative
+            compute->_sampler = sampler_t::make(device, {
+                .name = info.name + "_hiz_sampler",
+                .filter = { sampler_filter_t::e_linear },
+                .mip_mode = sampler_mipmap_mode_t::e_nearest,
+                .address_mode = { sampler_address_mode_t::e_clamp_to_edge },
+                .reduction_mode = sampler_reduction_mode_t::e_min,
+            });
+        }
+        if (!info.shadow_page_reduce.empty()) {
+            compute->_shadow_page_reduce = pipeline_t::make(device, compute_pipeline_create_info_t {
+                .name = info.name + "_shadow_page_reduce",
+                .compute = info.shadow_page_reduce,
+            });
+        }
+        compute->_info = info;
+        return compute;
+    }
+
+    auto async_compute_t::add_hiz_reduce(render_graph_t& graph, const async_reduce_info_t& info) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(_hiz_reduce != nullptr, "async_compute_t: hiz_reduce shader not set");
+        _reduce(graph, "hiz_reduce", *_hiz_reduce, info, true);
+    }
+
+    auto async_compute_t::add_shadow_page_reduce(render_graph_t& graph, const async_reduce_info_t& info) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(_shadow_page_reduce != nullptr, "async_compute_t: shadow_page_reduce shader not set");
+        _reduce(graph, "shadow_page_reduce", *_shadow_page_reduce, info, false);
+    }
+
+    auto async_compute_t::add_cull(
+        render_graph_t& graph,
+        const std::string& name,
+        const render_graph_t::setup_function_t& setup,
+        render_graph_t::execute_function_t execute
+    ) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        graph.add_pass({
+            .name = name,
+            .queue = queue_type_t::e_compute,
+            .is_side_effect = true,
+            .is_detached = true,
+        }, setup, std::move(execute));
+    }
+
+    auto async_compute_t::info() const noexcept -> const async_compute_create_info_t& {
+        IR_PROFILE_SCOPED();
+        return _info;
+    }
+
+    auto async_compute_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    auto async_compute_t::_reduce(
+        render_graph_t& graph,
+        const std::string& name,
+        const pipeline_t& pipeline,
+        const async_reduce_info_t& info,
+        bool is_sampled
+    ) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        // note: the graph sees one storage write of the whole chain, levels are ordered inside the pass
+        const auto usage = render_graph_usage_t {
+            .stage = pipeline_stage_t::e_compute_shader,
+            .access = resource_access_t::e_shader_storage_read | resource_access_t::e_shader_storage_write,
+            .layout = image_layout_t::e_general,
+        };
+        graph.add_pass({
+            .name = name,
+            .queue = queue_type_t::e_compute,
+            .is_side_effect = true,
+            .is_detached = info.is_detached,
+        }, [&](render_graph_builder_t& builder) {
+            builder.write(info.image, usage);
+        }, [this, &graph, &pipeline, resource = info.image, usage, is_sampled](command_buffer_t& command_buffer) {
+            const auto& image = graph.image(resource);
+            const auto& views = _views(image);
+            // note: the graph leaves the whole chain in the declared general layout, levels are ordered explicitly from there
+            const auto read_layout = is_sampled ? image_layout_t::e_shader_read_only_optimal : image_layout_t::e_general;
+            const auto read_access = is_sampled ? resource_access_t::e_shader_sampled_read : resource_access_t::e_shader_storage_read;
+            command_buffer.bind_pipeline(pipeline);
+            for (auto level = 1_u32; level < image.levels(); ++level) {
+                command_buffer.image_barrier({
+                    .image = std::cref(image),
+                    .source_stage = pipeline_stage_t::e_compute_shader,
+                    .dest_stage = pipeline_stage_t::e_compute_shader,
+                    .source_access = resource_access_t::e_shader_storage_write,
+                    .dest_access = read_access,
+                    .old_layout = usage.layout,
+                    .new_layout = read_layout,
+                    .subresource = { .level = level - 1, .level_count = 1 },
+                });
+
+                auto builder = descriptor_set_builder_t(pipeline, 0);
+                if (is_sampled) {
+                    builder.bind_combined_image_sampler(0, *views[level - 1], *_sampler);
+                } else {
+                    builder.bind_storage_image(0, *views[level - 1]);
+                }
+                builder.bind_storage_image(1, *views[level]);
+                command_buffer.bind_descriptor_set(*builder.build());
+
+                const auto constants = reduce_constants_t {
+                    .width = std::max(image.width() >> level, 1_u32),
+                    .height = std::max(image.height() >> level, 1_u32),
+                };
+                if (is_sampled) {
+                    command_buffer.push_constants(shader_stage_t::e_compute, 0, sizeof(constants), &constants);
+                }
+                command_buffer.dispatch((constants.width + 15) / 16, (constants.height + 15) / 16);
+            }
+            // note: the chain is left in the state the graph declared for the pass
+            if (is_sampled && image.levels() > 1) {
+                command_buffer.image_barrier({
+                    .image = std::cref(image),
+                    .source_stage = pipeline_stage_t::e_compute_shader,
+                    .dest_stage = usage.stage,
+                    .source_access = resource_access_t::e_none,
+                    .dest_access = usage.access,
+                    .old_layout = read_layout,
+                    .new_layout = usage.layout,
+                    .subresource = { .level = 0, .level_count = image.levels() - 1 },
+                });
+            }
+        });
+    }
+
+    auto async_compute_t::_views(const image_t& image) noexcept -> const std::vector<arc_ptr<image_view_t>>& {
+        IR_PROFILE_SCOPED();
+        // note: graph images only live for the frame, a new frame drops every entry rather than trusting a
+        // pointer and handle that may have been reused. released views are retired through the deletion queue
+        const auto frame = device().frame_counter().current();
+        if (frame != _frame) {
+            _level_views.clear();
+            _frame = frame;
+        }
+        auto& level_views = _level_views[&image];
+        if (level_views.handle == image.handle()) {
+            return level_views.views;
+        }
+        level_views.handle = image.handle();
+        level_views.views.clear();
+        level_views.views.reserve(image.levels());
+        for (auto level = 0_u32; level < image.levels(); ++level) {
+            level_views.views.emplace_back(image_view_t::make(image, {
+                .name = fmt::format("{}_level_{}", _info.name, level),
+                .subresource = {
+                    .level = level,
+                    .level_count = 1,
+                    .layer = 0,
+                    .layer_count = 1,
+                },
+            }));
+        }
+        return level_views.views;
+    }
+}
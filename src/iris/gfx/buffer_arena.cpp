@@ -0,0 +1,221 @@
+#include <iris/gfx/device.hpp>
+#include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/buffer_arena.hpp>
+
+namespace ir {
+    buffer_arena_t::buffer_arena_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    buffer_arena_t::~buffer_arena_t() noexcept {
+        IR_PROFILE_SCOPED();
+        vmaClearVirtualBlock(_block);
+        vmaDestroyVirtualBlock(_block);
+        IR_LOG_INFO(device().logger(), "buffer arena {} destroyed", fmt::ptr(_buffer->handle()));
+    }
+
+    auto buffer_arena_t::make(device_t& device, const buffer_arena_create_info_t& info) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto arena = arc_ptr<self>(new self(device));
+        auto block_info = VmaVirtualBlockCreateInfo();
+        block_info.size = info.capacity;
+        block_info.flags = {};
+        block_info.pAllocationCallbacks = nullptr;
+        IR_VULKAN_CHECK(device.logger(), vmaCreateVirtualBlock(&block_info, &arena->_block));
+        arena->_buffer = buffer_t<uint8>::make(device, {
+            .name = info.name,
+            .usage = info.usage | buffer_usage_t::e_transfer_src | buffer_usage_t::e_transfer_dst,
+            .memory = info.memory,
+            .flags = info.flags | buffer_flag_t::e_resized,
+            .capacity = info.capacity,
+        });
+        arena->_info = info;
+        IR_LOG_INFO(device.logger(), "buffer arena {} initialized (capacity: {})", fmt::ptr(arena->_buffer->handle()), info.capacity);
+        return arena;
+    }
+
+    auto buffer_arena_t::buffer() const noexcept -> const buffer_t<uint8>& {
+        IR_PROFILE_SCOPED();
+        return *_buffer;
+    }
+
+    auto buffer_arena_t::address() const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        return _buffer->address();
+    }
+
+    auto buffer_arena_t::stats() const noexcept -> buffer_arena_stats_t {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        auto statistics = VmaStatistics();
+        vmaGetVirtualBlockStatistics(_block, &statistics);
+        return {
+            .allocations = statistics.allocationCount,
+            .used = statistics.allocationBytes,
+            .capacity = _info.capacity,
+        };
+    }
+
+    auto buffer_arena_t::info() const noexcept -> const buffer_arena_create_info_t& {
+        IR_PROFILE_SCOPED();
+        return _info;
+    }
+
+    auto buffer_arena_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    auto buffer_arena_t::slice(const buffer_arena_allocation_t& allocation) const noexcept -> buffer_info_t {
+        IR_PROFILE_SCOPED();
+        return _buffer->slice(allocation.offset, allocation.size);
+    }
+
+    auto buffer_arena_t::address(const buffer_arena_allocation_t& allocation) const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        return _buffer->address() + allocation.offset;
+    }
+
+    auto buffer_arena_t::allocate(uint64 size, uint64 alignment) noexcept -> std::optional<buffer_arena_allocation_t> {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        auto allocation_info = VmaVirtualAllocationCreateInfo();
+        allocation_info.size = std::max(size, 1_u64);
+        allocation_info.alignment = alignment;
+        allocation_info.flags = {};
+        allocation_info.pUserData = nullptr;
+        auto allocation = buffer_arena_allocation_t();
+        if (vmaVirtualAllocate(_block, &allocation_info, &allocation.handle, &allocation.offset) != VK_SUCCESS) {
+            IR_LOG_WARN(device().logger(), "buffer_arena_t: out of space for {} bytes", size);
+            return std::nullopt;
+        }
+        allocation.size = size;
+        _ranges[allocation.handle] = {
+            .offset = allocation.offset,
+            .size = size,
+            .alignment = alignment,
+        };
+        return allocation;
+    }
+
+    auto buffer_arena_t::free(const buffer_arena_allocation_t& allocation) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        vmaVirtualFree(_block, allocation.handle);
+        _ranges.erase(allocation.handle);
+    }
+
+    auto buffer_arena_t::compact(command_buffer_t& command_buffer) noexcept -> std::vector<buffer_arena_relocation_t> {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        auto live = std::vector<std::pair<VmaVirtualAllocation, range_t>>(_ranges.begin(), _ranges.end());
+        std::sort(live.begin(), live.end(), [](const auto& left, const auto& right) {
+            return left.second.offset < right.second.offset;
+        });
+
+        vmaClearVirtualBlock(_block);
+        _ranges.clear();
+        auto relocations = std::vector<buffer_arena_relocation_t>();
+        relocations.reserve(live.size());
+        auto moved = 0_u64;
+        for (const auto& [previous, range] : live) {
+            auto allocation_info = VmaVirtualAllocationCreateInfo();
+            allocation_info.size = std::max(range.size, 1_u64);
+            allocation_info.alignment = range.alignment;
+            allocation_info.flags = {};
+            allocation_info.pUserData = nullptr;
+            auto allocation = buffer_arena_allocation_t();
+            IR_VULKAN_CHECK(device().logger(), vmaVirtualAllocate(_block, &allocation_info, &allocation.handle, &allocation.offset));
+            // note: the placement of an empty block is not specified, packing must never grow a range's offset
+            IR_ASSERT(allocation.offset <= range.offset, "buffer_arena_t: compaction moved a range forward");
+            allocation.size = range.size;
+            _ranges[allocation.handle] = {
+                .offset = allocation.offset,
+                .size = range.size,
+                .alignment = range.alignment,
+            };
+            if (allocation.offset != range.offset) {
+                moved += range.size;
+            }
+            relocations.emplace_back(buffer_arena_relocation_t {
+                .previous = previous,
+                .allocation = allocation,
+            });
+        }
+        if (moved == 0) {
+            return relocations;
+        }
+
+        // note: copy regions of a single vkCmdCopyBuffer must not overlap, moved ranges bounce through a scratch buffer
+        auto scratch_info = VkBufferCreateInfo();
+        scratch_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        scratch_info.pNext = nullptr;
+        scratch_info.flags = {};
+        scratch_info.size = moved;
+        scratch_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        scratch_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        auto scratch_allocation_info = VmaAllocationCreateInfo();
+        scratch_allocation_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        auto scratch_handle = VkBuffer();
+        auto scratch_allocation = VmaAllocation();
+        IR_VULKAN_CHECK(
+            device().logger(),
+            vmaCreateBuffer(
+                device().allocator(),
+                &scratch_info,
+                &scratch_allocation_info,
+                &scratch_handle,
+                &scratch_allocation,
+                nullptr));
+        const auto scratch = [scratch_handle](uint64 offset, uint64 size) {
+            return buffer_info_t {
+                .handle = scratch_handle,
+                .offset = offset,
+                .size = size,
+            };
+        };
+        // note: mapped arenas are copied on the device as well, frames in flight may still read the old offsets
+        command_buffer.memory_barrier({
+            .source_stage = pipeline_stage_t::e_all_commands,
+            .dest_stage = pipeline_stage_t::e_transfer,
+            .source_access = resource_access_t::e_memory_write,
+            .dest_access = resource_access_t::e_transfer_read | resource_access_t::e_transfer_write,
+        });
+        auto scratch_offset = 0_u64;
+        for (auto i = 0_u64; i < live.size(); ++i) {
+            const auto& range = live[i].second;
+            const auto& allocation = relocations[i].allocation;
+            if (allocation.offset != range.offset) {
+                command_buffer.copy_buffer(_buffer->slice(range.offset, range.size), scratch(scratch_offset, range.size), {});
+                scratch_offset += range.size;
+            }
+        }
+        command_buffer.memory_barrier({
+            .source_stage = pipeline_stage_t::e_transfer,
+            .dest_stage = pipeline_stage_t::e_transfer,
+            .source_access = resource_access_t::e_transfer_write,
+            .dest_access = resource_access_t::e_transfer_read,
+        });
+        scratch_offset = 0;
+        for (auto i = 0_u64; i < live.size(); ++i) {
+            const auto& range = live[i].second;
+            const auto& allocation = relocations[i].allocation;
+            if (allocation.offset != range.offset) {
+                command_buffer.copy_buffer(scratch(scratch_offset, range.size), _buffer->slice(allocation.offset, range.size), {});
+                scratch_offset += range.size;
+            }
+        }
+        command_buffer.memory_barrier({
+            .source_stage = pipeline_stage_t::e_transfer,
+            .dest_stage = pipeline_stage_t::e_all_commands,
+            .source_access = resource_access_t::e_transfer_write,
+            .dest_access = resource_access_t::e_memory_read | resource_access_t::e_memory_write,
+        });
+        // note: the scratch buffer must outlive the recorded copies
+        device().deletion_queue().push([scratch_handle, scratch_allocation](device_t& device) {
+            vmaDestroyBuffer(device.allocator(), scratch_handle, scratch_allocation);
+        });
+        return relocations;
+    }
+}
@@ -8,7 +8,305 @@
 #include <iris/gfx/framebuffer.hpp>
 #include <iris/gfx/image.hpp>
 
+#include <algorithm>
+
 namespace ir {
+    IR_NODISCARD static auto write_access(resource_access_t access) noexcept -> resource_access_t {
+        constexpr auto writes =
+            resource_access_t::e_shader_write |
+            resource_access_t::e_color_attachment_write |
+            resource_access_t::e_depth_stencil_attachment_write |
+            resource_access_t::e_transfer_write |
+            resource_access_t::e_host_write |
+            resource_access_t::e_memory_write |
+            resource_access_t::e_shader_storage_write |
+            resource_access_t::e_acceleration_structure_write;
+        return access & writes;
+    }
+
+    IR_NODISCARD static auto as_bind_point(pipeline_type_t type) noexcept -> VkPipelineBindPoint {
+        switch (type) {
+            case pipeline_type_t::e_graphics: return VK_PIPELINE_BIND_POINT_GRAPHICS;
+            case pipeline_type_t::e_compute: return VK_PIPELINE_BIND_POINT_COMPUTE;
+            case pipeline_type_t::e_ray_tracing: return VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR;
+        }
+        IR_UNREACHABLE();
+    }
+
+    static auto make_memory_barrier(const memory_barrier_t& barrier) noexcept -> VkMemoryBarrier2 {
+        IR_PROFILE_SCOPED();
+        auto memory_barrier = VkMemoryBarrier2();
+        memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        memory_barrier.pNext = nullptr;
+        memory_barrier.srcStageMask = as_enum_counterpart(barrier.source_stage);
+        memory_barrier.srcAccessMask = as_enum_counterpart(barrier.source_access);
+        memory_barrier.dstStageMask = as_enum_counterpart(barrier.dest_stage);
+        memory_barrier.dstAccessMask = as_enum_counterpart(barrier.dest_access);
+        return memory_barrier;
+    }
+
+    static auto make_buffer_barrier(const buffer_memory_barrier_t& barrier) noexcept -> VkBufferMemoryBarrier2 {
+        IR_PROFILE_SCOPED();
+        auto buffer_barrier = VkBufferMemoryBarrier2();
+        buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        buffer_barrier.pNext = nullptr;
+        buffer_barrier.srcStageMask = as_enum_counterpart(barrier.source_stage);
+        buffer_barrier.srcAccessMask = as_enum_counterpart(barrier.source_access);
+        buffer_barrier.dstStageMask = as_enum_counterpart(barrier.dest_stage);
+        buffer_barrier.dstAccessMask = as_enum_counterpart(barrier.dest_access);
+        buffer_barrier.srcQueueFamilyIndex = barrier.source_family;
+        buffer_barrier.dstQueueFamilyIndex = barrier.dest_family;
+        buffer_barrier.buffer = barrier.buffer.handle;
+        buffer_barrier.offset = barrier.buffer.offset;
+        buffer_barrier.size = barrier.buffer.size;
+        return buffer_barrier;
+    }
+
+    static auto make_image_barrier(const image_memory_barrier_t& barrier) noexcept -> VkImageMemoryBarrier2 {
+        IR_PROFILE_SCOPED();
+        const auto& image = barrier.image.get();
+        auto image_barrier = VkImageMemoryBarrier2();
+        image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        image_barrier.pNext = nullptr;
+        image_barrier.srcStageMask = as_enum_counterpart(barrier.source_stage);
+        image_barrier.srcAccessMask = as_enum_counterpart(barrier.source_access);
+        image_barrier.dstStageMask = as_enum_counterpart(barrier.dest_stage);
+        image_barrier.dstAccessMask = as_enum_counterpart(barrier.dest_access);
+        image_barrier.oldLayout = as_enum_counterpart(barrier.old_layout);
+        image_barrier.newLayout = as_enum_counterpart(barrier.new_layout);
+        image_barrier.srcQueueFamilyIndex = barrier.source_family;
+        image_barrier.dstQueueFamilyIndex = barrier.dest_family;
+        image_barrier.image = image.handle();
+        image_barrier.subresourceRange.aspectMask = as_enum_counterpart(image.view().aspect());
+        if (barrier.subresource.level != level_ignored) {
+            image_barrier.subresourceRange.baseMipLevel = barrier.subresource.level;
+            image_barrier.subresourceRange.levelCount = barrier.subresource.level_count;
+        } else {
+            image_barrier.subresourceRange.baseMipLevel = 0;
+            image_barrier.subresourceRange.levelCount = image.levels();
+        }
+        if (barrier.subresource.layer != layer_ignored) {
+            image_barrier.subresourceRange.baseArrayLayer = barrier.subresource.layer;
+            image_barrier.subresourceRange.layerCount = barrier.subresource.layer_count;
+        } else {
+            image_barrier.subresourceRange.baseArrayLayer = 0;
+            image_barrier.subresourceRange.layerCount = image.layers();
+        }
+        return image_barrier;
+    }
+
+    // note: the image is left in the barrier's destination state
+    static auto track_image_barrier(const image_memory_barrier_t& barrier) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        barrier.image.get().track({
+            .stage = barrier.dest_stage,
+            .access = barrier.dest_access,
+            .layout = barrier.new_layout,
+        }, barrier.subresource);
+    }
+
+    barrier_batch_t::barrier_batch_t() noexcept = default;
+
+    barrier_batch_t::~barrier_batch_t() noexcept = default;
+
+    auto barrier_batch_t::memory_barrier(const memory_barrier_t& barrier) noexcept -> self& {
+        IR_PROFILE_SCOPED();
+        const auto memory_barrier = make_memory_barrier(barrier);
+        if (!_has_memory) {
+            _memory = memory_barrier;
+            _has_memory = true;
+            return *this;
+        }
+        _memory.srcStageMask |= memory_barrier.srcStageMask;
+        _memory.srcAccessMask |= memory_barrier.srcAccessMask;
+        _memory.dstStageMask |= memory_barrier.dstStageMask;
+        _memory.dstAccessMask |= memory_barrier.dstAccessMask;
+        return *this;
+    }
+
+    auto barrier_batch_t::buffer_barrier(const buffer_memory_barrier_t& barrier) noexcept -> self& {
+        IR_PROFILE_SCOPED();
+        // note: ranges only matter for ownership transfers, drivers synchronize whole memory regardless
+        if (barrier.source_family == barrier.dest_family) {
+            return memory_barrier({
+                .source_stage = barrier.source_stage,
+                .dest_stage = barrier.dest_stage,
+                .source_access = barrier.source_access,
+                .dest_access = barrier.dest_access,
+            });
+        }
+        _buffers.emplace_back(make_buffer_barrier(barrier));
+        return *this;
+    }
+
+    auto barrier_batch_t::image_barrier(const image_memory_barrier_t& barrier) noexcept -> self& {
+        IR_PROFILE_SCOPED();
+        const auto image_barrier = make_image_barrier(barrier);
+        const auto& range = image_barrier.subresourceRange;
+        for (auto& each : _images) {
+            const auto& other = each.subresourceRange;
+            if (each.image == image_barrier.image &&
+                each.oldLayout == image_barrier.oldLayout &&
+                each.newLayout == image_barrier.newLayout &&
+                each.srcQueueFamilyIndex == image_barrier.srcQueueFamilyIndex &&
+                each.dstQueueFamilyIndex == image_barrier.dstQueueFamilyIndex &&
+                other.aspectMask == range.aspectMask &&
+                other.baseMipLevel == range.baseMipLevel &&
+                other.levelCount == range.levelCount &&
+                other.baseArrayLayer == range.baseArrayLayer &&
+                other.layerCount == range.layerCount
+            ) {
+                each.srcStageMask |= image_barrier.srcStageMask;
+                each.srcAccessMask |= image_barrier.srcAccessMask;
+                each.dstStageMask |= image_barrier.dstStageMask;
+                each.dstAccessMask |= image_barrier.dstAccessMask;
+                _track(barrier.image.get(), { barrier.dest_stage, barrier.dest_access, barrier.new_layout }, barrier.subresource);
+                return *this;
+            }
+        }
+        _images.emplace_back(image_barrier);
+        _track(barrier.image.get(), { barrier.dest_stage, barrier.dest_access, barrier.new_layout }, barrier.subresource);
+        return *this;
+    }
+
+    auto barrier_batch_t::transition(const image_t& image, const image_state_t& state, const image_subresource_t& subresource) noexcept -> self& {
+        IR_PROFILE_SCOPED();
+        const auto range = image.resolve(subresource);
+        // note: levels in the same state form one barrier, identical runs on consecutive layers are merged too
+        auto runs = std::vector<std::pair<image_subresource_t, image_state_t>>();
+        for (auto layer = range.layer; layer < range.layer + range.layer_count; ++layer) {
+            const auto end = range.level + range.level_count;
+            for (auto first = range.level; first < end;) {
+                const auto current = _state(image, first, layer);
+                auto last = first + 1;
+                while (last < end && _state(image, last, layer) == current) {
+                    ++last;
+                }
+                const auto run = std::find_if(runs.begin(), runs.end(), [&](const auto& each) {
+                    return
+                        each.first.level == first &&
+                        each.first.level_count == last - first &&
+                        each.first.layer + each.first.layer_count == layer &&
+                        each.second == current;
+                });
+                if (run != runs.end()) {
+                    run->first.layer_count++;
+                } else {
+                    runs.emplace_back(image_subresource_t { first, last - first, layer, 1 }, current);
+                }
+                first = last;
+            }
+        }
+        for (const auto& [each, current] : runs) {
+            const auto layout = state.layout == image_layout_t::e_undefined ? current.layout : state.layout;
+            const auto is_write =
+                write_access(current.access) != resource_access_t::e_none ||
+                write_access(state.access) != resource_access_t::e_none;
+            if (layout == current.layout && !is_write) {
+                // note: reads after reads only wait for stages that have not waited yet
+                if ((current.stage & state.stage) == state.stage && (current.access & state.access) == state.access) {
+                    continue;
+                }
+                image_barrier({
+                    .image = std::cref(image),
+                    .source_stage = current.stage,
+                    .dest_stage = state.stage,
+                    .source_access = resource_access_t::e_none,
+                    .dest_access = state.access,
+                    .old_layout = layout,
+                    .new_layout = layout,
+                    .subresource = each,
+                });
+                // note: later writes must wait for every read since the last write
+                _track(image, {
+                    .stage = current.stage | state.stage,
+                    .access = current.access | state.access,
+                    .layout = layout,
+                }, each);
+                continue;
+            }
+            image_barrier({
+                .image = std::cref(image),
+                .source_stage = current.stage,
+                .dest_stage = state.stage,
+                .source_access = write_access(current.access),
+                .dest_access = state.access,
+                .old_layout = current.layout,
+                .new_layout = layout,
+                .subresource = each,
+            });
+        }
+        return *this;
+    }
+
+    auto barrier_batch_t::is_empty() const noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        return !_has_memory && _buffers.empty() && _images.empty();
+    }
+
+    auto barrier_batch_t::dependency_info() const noexcept -> VkDependencyInfo {
+        IR_PROFILE_SCOPED();
+        auto dependency_info = VkDependencyInfo();
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.pNext = nullptr;
+        dependency_info.dependencyFlags = {};
+        dependency_info.memoryBarrierCount = _has_memory ? 1 : 0;
+        dependency_info.pMemoryBarriers = _has_memory ? &_memory : nullptr;
+        dependency_info.bufferMemoryBarrierCount = _buffers.size();
+        dependency_info.pBufferMemoryBarriers = _buffers.data();
+        dependency_info.imageMemoryBarrierCount = _images.size();
+        dependency_info.pImageMemoryBarriers = _images.data();
+        return dependency_info;
+    }
+
+    auto barrier_batch_t::flush(const command_buffer_t& command_buffer) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        command_buffer.pipeline_barrier(*this);
+        clear();
+    }
+
+    auto barrier_batch_t::clear() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        _memory = {};
+        _has_memory = false;
+        _buffers.clear();
+        _images.clear();
+        _tracks.clear();
+    }
+
+    auto barrier_batch_t::_state(const image_t& image, uint32 level, uint32 layer) const noexcept -> image_state_t {
+        IR_PROFILE_SCOPED();
+        // note: the latest barrier of this batch on the subresource wins over the state recorded so far
+        for (auto each = _tracks.rbegin(); each != _tracks.rend(); ++each) {
+            if (each->image != &image) {
+                continue;
+            }
+            const auto range = image.resolve(each->subresource);
+            if (level >= range.level && level < range.level + range.level_count &&
+                layer >= range.layer && layer < range.layer + range.layer_count
+            ) {
+                return each->state;
+            }
+        }
+        return image.state(level, layer);
+    }
+
+    auto barrier_batch_t::_track(const image_t& image, const image_state_t& state, const image_subresource_t& subresource) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        _tracks.emplace_back(image_track_t {
+            .image = &image,
+            .state = state,
+            .subresource = subresource,
+        });
+    }
+
+    auto barrier_batch_t::_apply() const noexcept -> void {
+        IR_PROFILE_SCOPED();
+        for (const auto& each : _tracks) {
+            each.image->track(each.state, each.subresource);
+        }
+    }
+
     command_buffer_t::command_buffer_t() noexcept = default;
 
     command_buffer_t::~command_buffer_t() noexcept {
@@ -104,11 +402,44 @@ namespace ir {
 
     auto command_buffer_t::begin() noexcept -> void {
         IR_PROFILE_SCOPED();
+        _reset_state();
         auto command_buffer_begin_info = VkCommandBufferBeginInfo();
         command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         command_buffer_begin_info.pNext = nullptr;
         command_buffer_begin_info.flags = 0;
         command_buffer_begin_info.pInheritanceInfo = nullptr;
+        // note: secondary command buffers always need inheritance info, even outside of a render pass
+        auto inheritance_info = VkCommandBufferInheritanceInfo();
+        if (!_info.primary) {
+            inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritance_info.pNext = nullptr;
+            command_buffer_begin_info.pInheritanceInfo = &inheritance_info;
+        }
+        IR_VULKAN_CHECK(pool().device().logger(), vkBeginCommandBuffer(_handle, &command_buffer_begin_info));
+    }
+
+    auto command_buffer_t::begin(const command_buffer_inheritance_info_t& inheritance) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!_info.primary, "command_buffer_t: inheritance requires a secondary command buffer");
+        const auto& framebuffer = inheritance.framebuffer.get();
+        _reset_state();
+        _state.framebuffer = &framebuffer;
+
+        auto inheritance_info = VkCommandBufferInheritanceInfo();
+        inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance_info.pNext = nullptr;
+        inheritance_info.renderPass = framebuffer.render_pass().handle();
+        inheritance_info.subpass = inheritance.subpass;
+        inheritance_info.framebuffer = framebuffer.handle();
+        inheritance_info.occlusionQueryEnable = false;
+        inheritance_info.queryFlags = {};
+        inheritance_info.pipelineStatistics = {};
+
+        auto command_buffer_begin_info = VkCommandBufferBeginInfo();
+        command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.pNext = nullptr;
+        command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        command_buffer_begin_info.pInheritanceInfo = &inheritance_info;
         IR_VULKAN_CHECK(pool().device().logger(), vkBeginCommandBuffer(_handle, &command_buffer_begin_info));
     }
 
@@ -130,7 +461,7 @@ namespace ir {
         vkCmdEndDebugUtilsLabelEXT(_handle);
     }
 
-    auto command_buffer_t::begin_render_pass(const framebuffer_t& framebuffer, const std::vector<clear_value_t>& clears) noexcept -> void {
+    auto command_buffer_t::begin_render_pass(const framebuffer_t& framebuffer, const std::vector<clear_value_t>& clears, bool secondary) noexcept -> void {
         IR_PROFILE_SCOPED();
         _state.framebuffer = &framebuffer;
 
@@ -161,11 +492,21 @@ namespace ir {
         };
         render_pass_begin_info.clearValueCount = clear_values.size();
         render_pass_begin_info.pClearValues = clear_values.data();
-        vkCmdBeginRenderPass(_handle, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBeginRenderPass(
+            _handle,
+            &render_pass_begin_info,
+            secondary ?
+                VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS :
+                VK_SUBPASS_CONTENTS_INLINE);
     }
 
-    auto command_buffer_t::set_viewport(const viewport_t& viewport, bool inverted) const noexcept -> void {
+    auto command_buffer_t::set_viewport(const viewport_t& viewport, bool inverted) noexcept -> void {
         IR_PROFILE_SCOPED();
+        if (_state.viewport == viewport && _state.is_viewport_inverted == inverted) {
+            return;
+        }
+        _state.viewport = viewport;
+        _state.is_viewport_inverted = inverted;
         auto v = VkViewport();
         v.x = viewport.x;
         if (inverted) {
@@ -184,8 +525,12 @@ namespace ir {
         vkCmdSetViewport(_handle, 0, 1, &v);
     }
 
-    auto command_buffer_t::set_scissor(const scissor_t& scissor) const noexcept -> void {
+    auto command_buffer_t::set_scissor(const scissor_t& scissor) noexcept -> void {
         IR_PROFILE_SCOPED();
+        if (_state.scissor == scissor) {
+            return;
+        }
+        _state.scissor = scissor;
         auto s = VkRect2D();
         s.offset = { scissor.x, scissor.y };
         s.extent = { scissor.width, scissor.height };
@@ -194,40 +539,97 @@ namespace ir {
 
     auto command_buffer_t::bind_pipeline(const pipeline_t& pipeline) noexcept -> void {
         IR_PROFILE_SCOPED();
-        _state.pipeline = &pipeline;
-        const auto bind_point = [&]() -> VkPipelineBindPoint {
-            switch (pipeline.type()) {
-                case pipeline_type_t::e_graphics: return VK_PIPELINE_BIND_POINT_GRAPHICS;
-                case pipeline_type_t::e_compute: return VK_PIPELINE_BIND_POINT_COMPUTE;
-                case pipeline_type_t::e_ray_tracing: return VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR;
+        if (_state.pipeline == &pipeline) {
+            return;
+        }
+        const auto bind_point = as_bind_point(pipeline.type());
+        // note: sets stay bound across pipelines only when the whole layout is the same
+        if (_state.bind_point != bind_point || _state.layout != pipeline.layout()) {
+            _state.sets = {};
+        }
+        // note: static viewport and scissor state of a graphics pipeline overrides the dynamic one
+        if (bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) {
+            const auto states = pipeline.dynamic_states();
+            if (std::find(states.begin(), states.end(), dynamic_state_t::e_viewport) == states.end()) {
+                _state.viewport.reset();
+            }
+            if (std::find(states.begin(), states.end(), dynamic_state_t::e_scissor) == states.end()) {
+                _state.scissor.reset();
             }
-            IR_UNREACHABLE();
-        }();
+        }
+        _state.pipeline = &pipeline;
+        _state.bind_point = bind_point;
+        _state.layout = pipeline.layout();
         vkCmdBindPipeline(_handle, bind_point, pipeline.handle());
     }
 
     auto command_buffer_t::bind_descriptor_set(const descriptor_set_t& set) noexcept -> void {
         IR_PROFILE_SCOPED();
-        const auto bind_point = [this]() -> VkPipelineBindPoint {
-            switch (_state.pipeline->type()) {
-                case pipeline_type_t::e_graphics: return VK_PIPELINE_BIND_POINT_GRAPHICS;
-                case pipeline_type_t::e_compute: return VK_PIPELINE_BIND_POINT_COMPUTE;
-                case pipeline_type_t::e_ray_tracing: return VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR;
-            }
-            IR_UNREACHABLE();
-        }();
+        IR_ASSERT(_state.pipeline != nullptr, "command_buffer_t: descriptor sets require a bound pipeline");
+        const auto index = set.layout().index();
         const auto handle = set.handle();
+        if (index < max_tracked_sets) {
+            if (_state.sets[index] == handle) {
+                return;
+            }
+            _state.sets[index] = handle;
+        }
         vkCmdBindDescriptorSets(
             _handle,
-            bind_point,
-            _state.pipeline->layout(),
-            set.layout().index(),
+            _state.bind_point,
+            _state.layout,
+            index,
             1,
             &handle,
             0,
             nullptr);
     }
 
+    auto command_buffer_t::bind_descriptor_sets(std::span<const std::reference_wrapper<const descriptor_set_t>> sets) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(_state.pipeline != nullptr, "command_buffer_t: descriptor sets require a bound pipeline");
+        auto bindings = std::vector<std::pair<uint32, VkDescriptorSet>>();
+        bindings.reserve(sets.size());
+        for (const auto& set : sets) {
+            bindings.emplace_back(set.get().layout().index(), set.get().handle());
+        }
+        std::sort(bindings.begin(), bindings.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+        auto handles = std::vector<VkDescriptorSet>();
+        handles.reserve(bindings.size());
+        for (auto first = 0_u32; first < bindings.size();) {
+            auto last = first + 1;
+            while (last < bindings.size() && bindings[last].first == bindings[last - 1].first + 1) {
+                ++last;
+            }
+            auto is_bound = true;
+            handles.clear();
+            for (auto i = first; i < last; ++i) {
+                const auto [index, handle] = bindings[i];
+                if (index >= max_tracked_sets || _state.sets[index] != handle) {
+                    is_bound = false;
+                }
+                if (index < max_tracked_sets) {
+                    _state.sets[index] = handle;
+                }
+                handles.emplace_back(handle);
+            }
+            if (!is_bound) {
+                vkCmdBindDescriptorSets(
+                    _handle,
+                    _state.bind_point,
+                    _state.layout,
+                    bindings[first].first,
+                    handles.size(),
+                    handles.data(),
+                    0,
+                    nullptr);
+            }
+            first = last;
+        }
+    }
+
     auto command_buffer_t::bind_vertex_buffer(const buffer_info_t& buffer) const noexcept -> void {
         IR_PROFILE_SCOPED();
         vkCmdBindVertexBuffers(_handle, 0, 1, &buffer.handle, &buffer.offset);
@@ -477,8 +879,8 @@ namespace ir {
     ) const noexcept -> void {
         IR_PROFILE_SCOPED();
         auto copy_region = VkBufferCopy();
-        copy_region.srcOffset = copy.source_offset;
-        copy_region.dstOffset = copy.dest_offset;
+        copy_region.srcOffset = source.offset + copy.source_offset;
+        copy_region.dstOffset = dest.offset + copy.dest_offset;
         copy_region.size = source.size;
         vkCmdCopyBuffer(_handle, source.handle, dest.handle, 1, &copy_region);
     }
@@ -524,14 +926,7 @@ namespace ir {
 
     auto command_buffer_t::memory_barrier(const memory_barrier_t& barrier) const noexcept -> void {
         IR_PROFILE_SCOPED();
-        auto memory_barrier = VkMemoryBarrier2();
-        memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
-        memory_barrier.pNext = nullptr;
-        memory_barrier.srcStageMask = as_enum_counterpart(barrier.source_stage);
-        memory_barrier.srcAccessMask = as_enum_counterpart(barrier.source_access);
-        memory_barrier.dstStageMask = as_enum_counterpart(barrier.dest_stage);
-        memory_barrier.dstAccessMask = as_enum_counterpart(barrier.dest_access);
-
+        const auto memory_barrier = make_memory_barrier(barrier);
         auto dependency_info = VkDependencyInfo();
         dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
         dependency_info.pNext = nullptr;
@@ -543,19 +938,7 @@ namespace ir {
 
     auto command_buffer_t::buffer_barrier(const buffer_memory_barrier_t& barrier) const noexcept -> void {
         IR_PROFILE_SCOPED();
-        auto buffer_barrier = VkBufferMemoryBarrier2();
-        buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
-        buffer_barrier.pNext = nullptr;
-        buffer_barrier.srcStageMask = as_enum_counterpart(barrier.source_stage);
-        buffer_barrier.srcAccessMask = as_enum_counterpart(barrier.source_access);
-        buffer_barrier.dstStageMask = as_enum_counterpart(barrier.dest_stage);
-        buffer_barrier.dstAccessMask = as_enum_counterpart(barrier.dest_access);
-        buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        buffer_barrier.buffer = barrier.buffer.handle;
-        buffer_barrier.offset = barrier.buffer.offset;
-        buffer_barrier.size = barrier.buffer.size;
-
+        const auto buffer_barrier = make_buffer_barrier(barrier);
         auto dependency_info = VkDependencyInfo();
         dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
         dependency_info.pNext = nullptr;
@@ -567,35 +950,7 @@ namespace ir {
 
     auto command_buffer_t::image_barrier(const image_memory_barrier_t& barrier) const noexcept -> void {
         IR_PROFILE_SCOPED();
-        const auto& image = barrier.image.get();
-        auto image_barrier = VkImageMemoryBarrier2();
-        image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
-        image_barrier.pNext = nullptr;
-        image_barrier.srcStageMask = as_enum_counterpart(barrier.source_stage);
-        image_barrier.srcAccessMask = as_enum_counterpart(barrier.source_access);
-        image_barrier.dstStageMask = as_enum_counterpart(barrier.dest_stage);
-        image_barrier.dstAccessMask = as_enum_counterpart(barrier.dest_access);
-        image_barrier.oldLayout = as_enum_counterpart(barrier.old_layout);
-        image_barrier.newLayout = as_enum_counterpart(barrier.new_layout);
-        image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        image_barrier.image = image.handle();
-        image_barrier.subresourceRange.aspectMask = as_enum_counterpart(image.view().aspect());
-        if (barrier.subresource.level != level_ignored) {
-            image_barrier.subresourceRange.baseMipLevel = barrier.subresource.level;
-            image_barrier.subresourceRange.levelCount = barrier.subresource.level_count;
-        } else {
-            image_barrier.subresourceRange.baseMipLevel = 0;
-            image_barrier.subresourceRange.levelCount = image.levels();
-        }
-        if (barrier.subresource.layer != layer_ignored) {
-            image_barrier.subresourceRange.baseArrayLayer = barrier.subresource.layer;
-            image_barrier.subresourceRange.layerCount = barrier.subresource.layer_count;
-        } else {
-            image_barrier.subresourceRange.baseArrayLayer = 0;
-            image_barrier.subresourceRange.layerCount = image.layers();
-        }
-
+        const auto image_barrier = make_image_barrier(barrier);
         auto dependency_info = VkDependencyInfo();
         dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
         dependency_info.pNext = nullptr;
@@ -603,10 +958,57 @@ namespace ir {
         dependency_info.imageMemoryBarrierCount = 1;
         dependency_info.pImageMemoryBarriers = &image_barrier;
         vkCmdPipelineBarrier2(_handle, &dependency_info);
+        track_image_barrier(barrier);
+    }
+
+    auto command_buffer_t::pipeline_barrier(const barrier_batch_t& batch) const noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (batch.is_empty()) {
+            return;
+        }
+        const auto dependency_info = batch.dependency_info();
+        vkCmdPipelineBarrier2(_handle, &dependency_info);
+        // note: batches built ahead of time, like the render graph's, only move the tracked state once recorded
+        batch._apply();
+    }
+
+    auto command_buffer_t::transition(const image_t& image, const image_state_t& state, const image_subresource_t& subresource) const noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto barriers = barrier_batch_t();
+        barriers.transition(image, state, subresource);
+        barriers.flush(*this);
+    }
+
+    auto command_buffer_t::execute_commands(const command_buffer_t& command_buffer) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        execute_commands({ std::cref(command_buffer) });
+    }
+
+    auto command_buffer_t::execute_commands(const std::vector<std::reference_wrapper<const command_buffer_t>>& command_buffers) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto handles = std::vector<VkCommandBuffer>();
+        handles.reserve(command_buffers.size());
+        for (const auto& command_buffer : command_buffers) {
+            IR_ASSERT(!command_buffer.get().info().primary, "command_buffer_t: only secondary command buffers can be executed");
+            handles.emplace_back(command_buffer.get().handle());
+        }
+        if (handles.empty()) {
+            return;
+        }
+        vkCmdExecuteCommands(_handle, handles.size(), handles.data());
+        // note: bound state is undefined after executing secondary command buffers
+        _reset_state();
     }
 
     auto command_buffer_t::end() const noexcept -> void {
         IR_PROFILE_SCOPED();
         IR_VULKAN_CHECK(pool().device().logger(), vkEndCommandBuffer(_handle));
     }
+
+    auto command_buffer_t::_reset_state() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto* framebuffer = _state.framebuffer;
+        _state = {};
+        _state.framebuffer = framebuffer;
+    }
 }
@@ -0,0 +1,188 @@
+#include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/defragmenter.hpp>
+#include <iris/gfx/device.hpp>
+
+namespace ir {
+    defragmenter_t::defragmenter_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    defragmenter_t::~defragmenter_t() noexcept {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        // note: the device is idle here, the pending copies have completed
+        _end();
+    }
+
+    auto defragmenter_t::make(device_t& device, const defragmenter_create_info_t& info) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto defragmenter = arc_ptr<self>(new self(device));
+        defragmenter->_info = info;
+        return defragmenter;
+    }
+
+    auto defragmenter_t::stats() const noexcept -> defragmentation_stats_t {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        return _stats;
+    }
+
+    auto defragmenter_t::info() const noexcept -> const defragmenter_create_info_t& {
+        IR_PROFILE_SCOPED();
+        return _info;
+    }
+
+    auto defragmenter_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    auto defragmenter_t::track(VmaAllocation allocation, defragmentation_target_t target) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        _targets.insert_or_assign(allocation, std::move(target));
+    }
+
+    auto defragmenter_t::untrack(VmaAllocation allocation) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        _targets.erase(allocation);
+    }
+
+    auto defragmenter_t::record(command_buffer_t& command_buffer) noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        auto callbacks = std::vector<std::function<void()>>();
+        const auto bytes = _record(command_buffer, callbacks);
+        // note: handles and addresses were swapped by the moves, work recorded from here on must use the new ones
+        for (const auto& callback : callbacks) {
+            callback();
+        }
+        return bytes;
+    }
+
+    auto defragmenter_t::_record(command_buffer_t& command_buffer, std::vector<std::function<void()>>& callbacks) noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        const auto frame = device().frame_counter().current();
+        if (_is_pass_pending || _targets.empty() || frame < _idle_until) {
+            return 0;
+        }
+        const auto allocator = device().allocator();
+        if (!_context) {
+            auto defragmentation_info = VmaDefragmentationInfo();
+            defragmentation_info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+            defragmentation_info.pool = nullptr;
+            defragmentation_info.maxBytesPerPass = _info.max_bytes_per_pass;
+            defragmentation_info.maxAllocationsPerPass = _info.max_moves_per_pass;
+            if (vmaBeginDefragmentation(allocator, &defragmentation_info, &_context) != VK_SUCCESS) {
+                _context = {};
+                _idle_until = frame + _info.idle_frames;
+                return 0;
+            }
+        }
+        _pass = {};
+        if (vmaBeginDefragmentationPass(allocator, _context, &_pass) == VK_SUCCESS) {
+            // note: nothing left to move, wait before trying again
+            _end();
+            _idle_until = frame + _info.idle_frames;
+            return 0;
+        }
+        auto bytes = 0_u64;
+        _moved.clear();
+        // note: one barrier per pass orders every copy after prior work and before later work
+        command_buffer.memory_barrier({
+            .source_stage = pipeline_stage_t::e_all_commands,
+            .dest_stage = pipeline_stage_t::e_transfer,
+            .source_access = resource_access_t::e_memory_write,
+            .dest_access = resource_access_t::e_transfer_read,
+        });
+        for (auto i = 0_u32; i < _pass.moveCount; ++i) {
+            auto& move = _pass.pMoves[i];
+            auto target = _targets.find(move.srcAllocation);
+            // note: untracked allocations are never moved, their owners hold raw pointers or descriptors we cannot patch
+            if (target == _targets.end() || !target->second.move(command_buffer, move.dstTmpAllocation)) {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+            auto allocation_info = VmaAllocationInfo();
+            vmaGetAllocationInfo(allocator, move.srcAllocation, &allocation_info);
+            bytes += allocation_info.size;
+            _moved.emplace_back(move.srcAllocation);
+        }
+        command_buffer.memory_barrier({
+            .source_stage = pipeline_stage_t::e_transfer,
+            .dest_stage = pipeline_stage_t::e_all_commands,
+            .source_access = resource_access_t::e_transfer_write,
+            .dest_access = resource_access_t::e_memory_read | resource_access_t::e_memory_write,
+        });
+        _pass_frame = frame;
+        _is_pass_pending = true;
+        if (!_moved.empty()) {
+            callbacks = _callbacks;
+        }
+        return bytes;
+    }
+
+    auto defragmenter_t::tick() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        if (!_is_pass_pending) {
+            return;
+        }
+        // note: the old memory is released by vmaEndDefragmentationPass, the copies must have retired
+        if (device().frame_counter().current() < _pass_frame + deletion_queue_t::frames_in_flight) {
+            return;
+        }
+        if (_finish_pass()) {
+            _end();
+            _idle_until = device().frame_counter().current() + _info.idle_frames;
+        }
+    }
+
+    auto defragmenter_t::on_relocation(std::function<void()> callback) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        _callbacks.emplace_back(std::move(callback));
+    }
+
+    auto defragmenter_t::_end() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (!_context) {
+            return;
+        }
+        if (_is_pass_pending) {
+            _finish_pass();
+        }
+        auto stats = VmaDefragmentationStats();
+        vmaEndDefragmentation(device().allocator(), _context, &stats);
+        _context = {};
+        _stats.bytes_moved += stats.bytesMoved;
+        _stats.bytes_freed += stats.bytesFreed;
+        if (stats.bytesMoved != 0) {
+            IR_LOG_INFO(
+                device().logger(),
+                "defragmentation moved {} allocations ({} bytes), freed {} blocks ({} bytes)",
+                stats.allocationsMoved,
+                stats.bytesMoved,
+                stats.deviceMemoryBlocksFreed,
+                stats.bytesFreed);
+        }
+    }
+
+    auto defragmenter_t::_finish_pass() noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        _is_pass_pending = false;
+        const auto is_complete = vmaEndDefragmentationPass(device().allocator(), _context, &_pass) == VK_SUCCESS;
+        // note: the source allocations now refer to the new memory, owners drop their stale handles here
+        for (const auto allocation : _moved) {
+            if (auto target = _targets.find(allocation); target != _targets.end() && target->second.commit) {
+                target->second.commit();
+            }
+        }
+        _stats.moves += _moved.size();
+        _stats.passes++;
+        _moved.clear();
+        return is_complete;
+    }
+}
@@ -1,29 +1,85 @@
 #include <iris/gfx/deletion_queue.hpp>
+#include <iris/gfx/semaphore.hpp>
 #include <iris/gfx/device.hpp>
 
 namespace ir {
-    deletion_queue_t::deletion_queue_t() noexcept {
+    deletion_queue_t::deletion_queue_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
         IR_PROFILE_SCOPED();
-        _entries.reserve(128);
     }
 
-    deletion_queue_t::~deletion_queue_t() noexcept = default;
+    deletion_queue_t::~deletion_queue_t() noexcept {
+        IR_PROFILE_SCOPED();
+        flush();
+    }
 
-    auto deletion_queue_t::make(device_t& device) noexcept -> self {
+    auto deletion_queue_t::make(device_t& device) noexcept -> arc_ptr<self> {
         IR_PROFILE_SCOPED();
-        auto queue = self();
-        queue._device = device.as_intrusive_ptr();
+        auto queue = arc_ptr<self>(new self(device));
+        queue->_entries.reserve(128);
         return queue;
     }
 
+    auto deletion_queue_t::size() const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        return _entries.size();
+    }
+
     auto deletion_queue_t::tick() noexcept -> void {
         IR_PROFILE_SCOPED();
-        _entries.erase(std::remove_if(_entries.begin(), _entries.end(), [](entry& entry) {
-            if (entry.ttl-- == 0) {
-                IR_LOG_WARN(spdlog::get("device"), "deletion_queue_t: TTL expired for object with callback {}", fmt::ptr(&entry.callback));
-                return true;
-            }
-            return false;
-        }), _entries.end());
+        const auto frame = _current_frame();
+        auto retired = std::vector<entry>();
+        {
+            auto lock = std::lock_guard(_lock);
+            // note: entries tend to share a timeline, query each one once per tick
+            auto timeline = (const semaphore_t*)(nullptr);
+            auto completed = 0_u64;
+            const auto is_retired = [&](const entry& entry) {
+                if (entry.frame > frame) {
+                    return false;
+                }
+                if (!entry.timeline) {
+                    return true;
+                }
+                if (entry.timeline.get() != timeline) {
+                    timeline = entry.timeline.get();
+                    completed = timeline->value();
+                }
+                return entry.value <= completed;
+            };
+            const auto middle = std::stable_partition(_entries.begin(), _entries.end(), [&](const entry& entry) {
+                return !is_retired(entry);
+            });
+            retired.reserve(std::distance(middle, _entries.end()));
+            std::move(middle, _entries.end(), std::back_inserter(retired));
+            _entries.erase(middle, _entries.end());
+        }
+        for (auto& each : retired) {
+            each.callback(_device.get());
+        }
+    }
+
+    auto deletion_queue_t::flush() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto retired = std::vector<entry>();
+        {
+            auto lock = std::lock_guard(_lock);
+            retired.swap(_entries);
+        }
+        for (auto& each : retired) {
+            each.callback(_device.get());
+        }
+    }
+
+    auto deletion_queue_t::_push(entry&& entry) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        _entries.emplace_back(std::move(entry));
+    }
+
+    auto deletion_queue_t::_current_frame() const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        return _device.get().frame_counter().current();
     }
 }
@@ -11,6 +11,9 @@ namespace ir {
 
     descriptor_layout_t::~descriptor_layout_t() noexcept {
         IR_PROFILE_SCOPED();
+        if (_update_template) {
+            vkDestroyDescriptorUpdateTemplate(device().handle(), _update_template, nullptr);
+        }
         vkDestroyDescriptorSetLayout(device().handle(), _handle, nullptr);
         IR_LOG_INFO(device().logger(), "descriptor layout {} freed", fmt::ptr(_handle));
     }
@@ -58,6 +61,63 @@ namespace ir {
         IR_LOG_INFO(device.logger(), "descriptor layout initialized {}", fmt::ptr(layout->_handle));
         layout->_bindings = std::vector(info.bindings.begin(), info.bindings.end());
 
+        // note: dynamic (variable count) and texel buffer bindings are not part of the template
+        auto template_entries = std::vector<VkDescriptorUpdateTemplateEntry>();
+        template_entries.reserve(info.bindings.size());
+        layout->_update_offsets.resize(info.bindings.size(), -1_u32);
+        for (const auto& binding : info.bindings) {
+            if (binding.count == 0 || binding.is_dynamic) {
+                continue;
+            }
+            switch (binding.type) {
+                case descriptor_type_t::e_sampler:
+                case descriptor_type_t::e_combined_image_sampler:
+                case descriptor_type_t::e_sampled_image:
+                case descriptor_type_t::e_storage_image:
+                case descriptor_type_t::e_input_attachment:
+                case descriptor_type_t::e_uniform_buffer:
+                case descriptor_type_t::e_storage_buffer:
+                case descriptor_type_t::e_uniform_buffer_dynamic:
+                case descriptor_type_t::e_storage_buffer_dynamic:
+                    break;
+
+                default:
+                    continue;
+            }
+            auto entry = VkDescriptorUpdateTemplateEntry();
+            entry.dstBinding = binding.binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = binding.count;
+            entry.descriptorType = as_enum_counterpart(binding.type);
+            entry.offset = layout->_update_size;
+            entry.stride = sizeof(descriptor_update_entry_t);
+            template_entries.emplace_back(entry);
+            layout->_update_offsets[binding.binding] = layout->_update_size;
+            layout->_update_size += binding.count * sizeof(descriptor_update_entry_t);
+        }
+        layout->_update_count = template_entries.size();
+
+        if (!template_entries.empty()) {
+            auto template_info = VkDescriptorUpdateTemplateCreateInfo();
+            template_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+            template_info.pNext = nullptr;
+            template_info.flags = 0;
+            template_info.descriptorUpdateEntryCount = template_entries.size();
+            template_info.pDescriptorUpdateEntries = template_entries.data();
+            template_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+            template_info.descriptorSetLayout = layout->_handle;
+            template_info.pipelineBindPoint = {};
+            template_info.pipelineLayout = {};
+            template_info.set = 0;
+            IR_VULKAN_CHECK(
+                device.logger(),
+                vkCreateDescriptorUpdateTemplate(
+                    device.handle(),
+                    &template_info,
+                    nullptr,
+                    &layout->_update_template));
+        }
+
         if (!info.name.empty()) {
             device.set_debug_name({
                 .type = VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
@@ -73,6 +133,11 @@ namespace ir {
         return _handle;
     }
 
+    auto descriptor_layout_t::update_template() const noexcept -> VkDescriptorUpdateTemplate {
+        IR_PROFILE_SCOPED();
+        return _update_template;
+    }
+
     auto descriptor_layout_t::device() const noexcept -> device_t& {
         IR_PROFILE_SCOPED();
         return _device.get();
@@ -100,4 +165,22 @@ namespace ir {
         IR_PROFILE_SCOPED();
         return !_bindings.empty() && _bindings.back().is_dynamic;
     }
+
+    auto descriptor_layout_t::update_offset(uint32 binding) const noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        if (binding >= _update_offsets.size()) {
+            return -1_u32;
+        }
+        return _update_offsets[binding];
+    }
+
+    auto descriptor_layout_t::update_size() const noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        return _update_size;
+    }
+
+    auto descriptor_layout_t::update_count() const noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        return _update_count;
+    }
 }
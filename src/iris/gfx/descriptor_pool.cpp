@@ -94,4 +94,17 @@ namespace ir {
         IR_PROFILE_SCOPED();
         return _sizes.at(type);
     }
+
+    auto descriptor_pool_t::allocate(VkDescriptorSetAllocateInfo& info, VkDescriptorSet& set) const noexcept -> VkResult {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        info.descriptorPool = _handle;
+        return vkAllocateDescriptorSets(device().handle(), &info, &set);
+    }
+
+    auto descriptor_pool_t::free(VkDescriptorSet set) const noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        vkFreeDescriptorSets(device().handle(), _handle, 1, &set);
+    }
 }
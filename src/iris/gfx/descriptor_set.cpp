@@ -17,7 +17,7 @@ namespace ir {
 
     descriptor_set_t::~descriptor_set_t() noexcept {
         IR_PROFILE_SCOPED();
-        vkFreeDescriptorSets(device().handle(), pool().handle(), 1, &_handle);
+        pool().free(_handle);
         IR_LOG_INFO(device().logger(), "descriptor set {} freed", fmt::ptr(_handle));
     }
 
@@ -28,7 +28,7 @@ namespace ir {
     ) noexcept -> arc_ptr<self> {
         IR_PROFILE_SCOPED();
         auto set = arc_ptr<self>(new self(device));
-        const auto* pool = &device.descriptor_pool();
+        auto pool = device.descriptor_pool();
         const auto layout_handle = layout.handle();
         auto dynamic_count = 0_u32;
         auto variable_count_info = VkDescriptorSetVariableDescriptorCountAllocateInfo();
@@ -51,7 +51,7 @@ namespace ir {
         allocate_info.descriptorPool = pool->handle();
         allocate_info.descriptorSetCount = 1;
         allocate_info.pSetLayouts = &layout_handle;
-        auto result = vkAllocateDescriptorSets(device.handle(), &allocate_info, &set->_handle);
+        auto result = pool->allocate(allocate_info, set->_handle);
 
         if (result == VK_ERROR_OUT_OF_POOL_MEMORY) {
             IR_LOG_WARN(device.logger(), "descriptor_pool_t: memory exhausted, reallocating");
@@ -65,14 +65,13 @@ namespace ir {
                     new_sizes[type] = new_size;
                 }
             }
-            device.resize_descriptor_pool(new_sizes);
-            pool = &device.descriptor_pool();
-            allocate_info.descriptorPool = pool->handle();
+            device.resize_descriptor_pool(*pool, new_sizes);
+            pool = device.descriptor_pool();
             // if this fails we are in big trouble
-            IR_VULKAN_CHECK(device.logger(), vkAllocateDescriptorSets(device.handle(), &allocate_info, &set->_handle));
+            IR_VULKAN_CHECK(device.logger(), pool->allocate(allocate_info, set->_handle));
         }
         IR_LOG_INFO(device.logger(), "allocated descriptor set {}", fmt::ptr(set->_handle));
-        set->_pool = pool->as_intrusive_ptr();
+        set->_pool = std::move(pool);
         set->_layout = layout.as_intrusive_ptr();
 
         if (!name.empty()) {
@@ -108,7 +107,7 @@ namespace ir {
     descriptor_set_builder_t::descriptor_set_builder_t(const descriptor_layout_t& layout) noexcept
         : _layout(std::cref(layout)) {
         IR_PROFILE_SCOPED();
-        _binding.pool = layout.device().descriptor_pool().handle();
+        _binding.pool = layout.device().descriptor_pool()->handle();
         _binding.layout = layout.handle();
         _binding.bindings.reserve(1024);
     }
@@ -255,12 +254,53 @@ namespace ir {
 
     auto descriptor_set_builder_t::build() const noexcept -> arc_ptr<descriptor_set_t> {
         IR_PROFILE_SCOPED();
-        auto& device = _layout.get().device();
+        const auto& layout = _layout.get();
+        auto& device = layout.device();
         auto& cache = device.cache<descriptor_set_t>();
-        if (cache.contains(_binding)) {
-            return cache.acquire(_binding);
+        if (auto set = cache.try_acquire(_binding)) {
+            return std::move(*set);
         }
-        auto set = cache.insert(_binding, descriptor_set_t::make(device, _layout.get()));
+        auto set = descriptor_set_t::make(device, layout);
+        IR_LOG_WARN(device.logger(), "descriptor_set_t ({}): cache miss", fmt::ptr(set->handle()));
+
+        // fast path: every templated binding is fully written, pack everything into a single blob
+        auto is_templated = layout.update_template() != nullptr;
+        auto template_data = std::vector<uint8>();
+        if (is_templated) {
+            auto covered = 0_u32;
+            template_data.resize(layout.update_size());
+            for (const auto& binding : _binding.bindings) {
+                const auto offset = layout.update_offset(binding.binding);
+                if (offset == -1_u32 || binding.contents.empty()) {
+                    continue;
+                }
+                if (binding.contents.size() != layout.binding(binding.binding).count) {
+                    is_templated = false;
+                    break;
+                }
+                auto* entries = reinterpret_cast<descriptor_update_entry_t*>(template_data.data() + offset);
+                for (auto i = 0_u32; i < binding.contents.size(); ++i) {
+                    const auto& content = binding.contents[i];
+                    if (const auto* image = std::get_if<image_info_t>(&content)) {
+                        entries[i].image = VkDescriptorImageInfo {
+                            .sampler = image->sampler,
+                            .imageView = image->view,
+                            .imageLayout = as_enum_counterpart(image->layout)
+                        };
+                    } else {
+                        const auto& buffer = std::get<buffer_info_t>(content);
+                        entries[i].buffer = VkDescriptorBufferInfo {
+                            .buffer = buffer.handle,
+                            .offset = buffer.offset,
+                            .range = buffer.size
+                        };
+                    }
+                }
+                covered++;
+            }
+            is_templated = is_templated && covered == layout.update_count();
+        }
+
         auto buffer_infos = std::vector<std::vector<VkDescriptorBufferInfo>>();
         auto image_infos = std::vector<std::vector<VkDescriptorImageInfo>>();
         auto writes = std::vector<VkWriteDescriptorSet>();
@@ -269,6 +309,9 @@ namespace ir {
             if (binding.contents.empty()) {
                 continue;
             }
+            if (is_templated && layout.update_offset(binding.binding) != -1_u32) {
+                continue;
+            }
             auto write = VkWriteDescriptorSet();
             write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
             write.pNext = nullptr;
@@ -323,8 +366,13 @@ namespace ir {
             }
             writes.emplace_back(write);
         }
-        IR_LOG_WARN(device.logger(), "descriptor_set_t ({}): cache miss", fmt::ptr(set->handle()));
-        vkUpdateDescriptorSets(device.handle(), writes.size(), writes.data(), 0, nullptr);
-        return set;
+        if (is_templated) {
+            vkUpdateDescriptorSetWithTemplate(device.handle(), set->handle(), layout.update_template(), template_data.data());
+        }
+        if (!writes.empty()) {
+            vkUpdateDescriptorSets(device.handle(), writes.size(), writes.data(), 0, nullptr);
+        }
+        // publish only fully written sets, if another thread won the race its set is returned instead
+        return cache.insert(_binding, std::move(set));
     }
 }
@@ -1,14 +1,22 @@
+#include <iris/gfx/defragmenter.hpp>
 #include <iris/gfx/descriptor_layout.hpp>
 #include <iris/gfx/descriptor_pool.hpp>
 #include <iris/gfx/descriptor_set.hpp>
 #include <iris/gfx/instance.hpp>
 #include <iris/gfx/device.hpp>
 #include <iris/gfx/queue.hpp>
+#include <iris/gfx/resource_pool.hpp>
+#include <iris/gfx/upload_ring.hpp>
+#include <iris/gfx/upload_service.hpp>
 
 #include <iris/nvidia/ngx_wrapper.hpp>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 namespace ir {
     template <typename T, typename U>
     static auto append_extension_chain(T& self, U* next) noexcept -> void {
@@ -28,6 +36,12 @@ namespace ir {
         _descriptor_layouts.clear();
         _descriptor_sets.clear();
         _descriptor_pool.reset();
+        _resource_pool.reset();
+        _upload_service.reset();
+        _upload_ring.reset();
+        wait_idle();
+        _defragmenter.reset();
+        _deletion_queue.reset();
         _transfer.reset();
         _compute.reset();
         _graphics.reset();
@@ -161,6 +175,21 @@ namespace ir {
                 extensions.emplace_back(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME);
                 extensions.emplace_back(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME);
             }
+            {
+                auto extension_count = 0_u32;
+                vkEnumerateDeviceExtensionProperties(device->_gpu, nullptr, &extension_count, nullptr);
+                auto available_extensions = std::vector<VkExtensionProperties>(extension_count);
+                vkEnumerateDeviceExtensionProperties(device->_gpu, nullptr, &extension_count, available_extensions.data());
+                device->_is_memory_budget_enabled = std::any_of(
+                    available_extensions.begin(),
+                    available_extensions.end(),
+                    [](const auto& each) {
+                        return std::strcmp(each.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0;
+                    });
+                if (device->_is_memory_budget_enabled) {
+                    extensions.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+                }
+            }
 
 #if defined(IRIS_NVIDIA_DLSS)
             const auto ngx_common_info = make_ngx_feature_common_info();
@@ -344,7 +373,8 @@ namespace ir {
             device->_graphics = queue_t::make(*device, {
                 .name = "main_graphics_queue",
                 .family = *graphics_family,
-                .type = queue_type_t::e_graphics
+                .type = queue_type_t::e_graphics,
+                .threaded = info.threaded_submission,
             });
             device->_compute = device->_graphics;
             device->_transfer = device->_graphics;
@@ -352,20 +382,36 @@ namespace ir {
                 device->_compute = queue_t::make(*device, {
                     .name = "main_compute_queue",
                     .family = *compute_family,
-                    .type = queue_type_t::e_compute
+                    .type = queue_type_t::e_compute,
+                    .threaded = info.threaded_submission,
                 });
             }
             if (transfer_family != graphics_family && transfer_family != compute_family) {
                 device->_transfer = queue_t::make(*device, {
                     .name = "main_transfer_queue",
                     .family = *transfer_family,
-                    .type = queue_type_t::e_transfer
+                    .type = queue_type_t::e_transfer,
+                    .threaded = info.threaded_submission,
                 });
             }
 
             device->_properties = properties2;
             device->_properties_rt = properties_rt;
             device->_memory_properties = memory_properties;
+            // note: without resizable BAR the host-visible device-local window is capped at 256 MiB
+            for (auto i = 0_u32; i < memory_properties.memoryProperties.memoryTypeCount; ++i) {
+                constexpr static auto rebar_flags =
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+                const auto& type = memory_properties.memoryProperties.memoryTypes[i];
+                const auto& heap = memory_properties.memoryProperties.memoryHeaps[type.heapIndex];
+                if ((type.propertyFlags & rebar_flags) == rebar_flags && heap.size > 256_MiB) {
+                    device->_rebar_heap = type.heapIndex;
+                    IR_LOG_INFO(logger, "resizable BAR detected (heap: {}, size: {})", type.heapIndex, heap.size);
+                    break;
+                }
+            }
             device->_features = features2;
             device->_features_11 = features_11;
             device->_features_12 = features_12;
@@ -386,6 +432,9 @@ namespace ir {
             if (device_features.bufferDeviceAddress) {
                 vma_info.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
             }
+            if (device->_is_memory_budget_enabled) {
+                vma_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+            }
             vma_info.physicalDevice = device->_gpu;
             vma_info.device = device->_handle;
             vma_info.preferredLargeHeapBlockSize = 0;
@@ -410,7 +459,14 @@ namespace ir {
 #endif
 
         device->_descriptor_pool = descriptor_pool_t::make(device.as_ref(), 1024, "main_descriptor_pool");
+        device->_upload_ring = upload_ring_t::make(device.as_ref(), {
+            .name = "main_upload_ring",
+        });
+        device->_upload_service = upload_service_t::make(device.as_ref());
         device->_frame_counter = master_frame_counter_t::make();
+        device->_deletion_queue = deletion_queue_t::make(device.as_ref());
+        device->_defragmenter = defragmenter_t::make(device.as_ref());
+        device->_resource_pool = resource_pool_t::make(device.as_ref());
 
         if (!info.name.empty()) {
             device->set_debug_name(debug_name_info_t {
@@ -484,9 +540,20 @@ namespace ir {
         return *_transfer;
     }
 
-    auto device_t::descriptor_pool() const noexcept -> const descriptor_pool_t& {
+    auto device_t::descriptor_pool() const noexcept -> arc_ptr<const descriptor_pool_t> {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_descriptor_pool_lock);
+        return _descriptor_pool.as_const_ref().as_intrusive_ptr();
+    }
+
+    auto device_t::upload_ring() noexcept -> upload_ring_t& {
+        IR_PROFILE_SCOPED();
+        return *_upload_ring;
+    }
+
+    auto device_t::upload_service() noexcept -> upload_service_t& {
         IR_PROFILE_SCOPED();
-        return *_descriptor_pool;
+        return *_upload_service;
     }
 
     auto device_t::frame_counter() noexcept -> master_frame_counter_t& {
@@ -499,9 +566,19 @@ namespace ir {
         return *_frame_counter;
     }
 
-    auto device_t::deletion_queue() noexcept -> deletion_queue_t& {
+    auto device_t::deletion_queue() const noexcept -> deletion_queue_t& {
+        IR_PROFILE_SCOPED();
+        return *_deletion_queue.get();
+    }
+
+    auto device_t::defragmenter() const noexcept -> defragmenter_t& {
+        IR_PROFILE_SCOPED();
+        return *_defragmenter.get();
+    }
+
+    auto device_t::resource_pool() const noexcept -> resource_pool_t& {
         IR_PROFILE_SCOPED();
-        return _deletion_queue;
+        return *_resource_pool.get();
     }
 
     auto device_t::info() const noexcept -> const device_create_info_t& {
@@ -551,28 +628,42 @@ namespace ir {
 
     auto device_t::wait_idle() const noexcept -> void {
         IR_PROFILE_SCOPED();
+        // note: work still queued on a submit thread would not be covered otherwise
+        for (const auto& queue : { _graphics, _compute, _transfer }) {
+            if (queue != nullptr) {
+                queue->drain();
+            }
+        }
         IR_VULKAN_CHECK(_logger, vkDeviceWaitIdle(_handle));
     }
 
-    auto device_t::resize_descriptor_pool(const akl::fast_hash_map<descriptor_type_t, uint32>& size) noexcept -> void {
+    auto device_t::resize_descriptor_pool(
+        const descriptor_pool_t& exhausted,
+        const akl::fast_hash_map<descriptor_type_t, uint32>& size
+    ) noexcept -> void {
         IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_descriptor_pool_lock);
+        // another thread already grew the pool
+        if (_descriptor_pool.get() != &exhausted) {
+            return;
+        }
         _descriptor_pool = descriptor_pool_t::make(*this, size);
     }
 
     template <>
-    auto device_t::cache() noexcept -> cache_t<descriptor_layout_t>& {
+    auto device_t::cache() noexcept -> concurrent_cache_t<descriptor_layout_t>& {
         IR_PROFILE_SCOPED();
         return _descriptor_layouts;
     }
 
     template <>
-    auto device_t::cache() noexcept -> cache_t<descriptor_set_t>& {
+    auto device_t::cache() noexcept -> concurrent_cache_t<descriptor_set_t>& {
         IR_PROFILE_SCOPED();
         return _descriptor_sets;
     }
 
     template <>
-    auto device_t::cache() noexcept -> cache_t<sampler_t>& {
+    auto device_t::cache() noexcept -> concurrent_cache_t<sampler_t>& {
         IR_PROFILE_SCOPED();
         return _samplers;
     }
@@ -581,15 +672,121 @@ namespace ir {
         IR_PROFILE_SCOPED();
         switch (feature) {
             case device_feature_t::e_buffer_device_address: return _features_12.bufferDeviceAddress;
+            case device_feature_t::e_memory_budget: return _is_memory_budget_enabled;
+            case device_feature_t::e_resizable_bar: return _rebar_heap != -1_u32;
         }
         IR_UNREACHABLE();
     }
 
+    auto device_t::memory_stats() const noexcept -> memory_stats_t {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_memory_stats_lock);
+        return _memory_stats;
+    }
+
+    auto device_t::memory_pressure() const noexcept -> memory_pressure_t {
+        IR_PROFILE_SCOPED();
+        return _memory_pressure.load(std::memory_order_relaxed);
+    }
+
+    auto device_t::on_memory_pressure(std::function<void(memory_pressure_t)> callback) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_memory_stats_lock);
+        _memory_pressure_callbacks.emplace_back(std::move(callback));
+    }
+
+    auto device_t::buffer_placement(uint64 bytes) const noexcept -> buffer_placement_t {
+        IR_PROFILE_SCOPED();
+        constexpr static auto direct_write_limit = 16_MiB;
+        // note: leaves headroom for the render targets that must live in the same heap
+        constexpr static auto direct_write_budget_ratio = 0.8f;
+        if (!is_supported(device_feature_t::e_resizable_bar) || bytes > direct_write_limit) {
+            return buffer_placement_t::e_staged;
+        }
+        if (memory_pressure() != memory_pressure_t::e_none) {
+            return buffer_placement_t::e_staged;
+        }
+        // note: queried on demand, allocations made since the last tick() are already accounted for
+        auto budgets = std::array<VmaBudget, VK_MAX_MEMORY_HEAPS>();
+        vmaGetHeapBudgets(_allocator, budgets.data());
+        const auto& budget = budgets[_rebar_heap];
+        const auto limit = static_cast<uint64>(static_cast<float32>(budget.budget) * direct_write_budget_ratio);
+        if (budget.usage + bytes > limit) {
+            return buffer_placement_t::e_staged;
+        }
+        return buffer_placement_t::e_direct;
+    }
+
     auto device_t::tick() noexcept -> void {
         IR_PROFILE_SCOPED();
         frame_counter().tick();
+        _refresh_memory_stats();
+        _defragmenter->tick();
         deletion_queue().tick();
+        _upload_service->tick();
+        _resource_pool->tick();
         _descriptor_layouts.tick();
         _descriptor_sets.tick();
+        if (frame_counter().current() % 1024 == 0) {
+            const auto stats = _descriptor_sets.stats();
+            IR_LOG_INFO(
+                spdlog::get("cache"),
+                "descriptor_set_t cache: {} live, {} hits, {} misses, {} inserts, {} evictions",
+                stats.live,
+                stats.hits,
+                stats.misses,
+                stats.inserts,
+                stats.evictions);
+        }
+    }
+
+    auto device_t::_refresh_memory_stats() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        constexpr static auto high_pressure_ratio = 0.85f;
+        constexpr static auto critical_pressure_ratio = 0.95f;
+        // note: VMA refreshes budgets from VK_EXT_memory_budget once per frame index
+        vmaSetCurrentFrameIndex(_allocator, static_cast<uint32>(frame_counter().current()));
+        const auto& properties = memory_properties();
+        auto budgets = std::array<VmaBudget, VK_MAX_MEMORY_HEAPS>();
+        vmaGetHeapBudgets(_allocator, budgets.data());
+        auto stats = memory_stats_t();
+        stats.heaps.reserve(properties.memoryHeapCount);
+        auto ratio = 0.0f;
+        for (auto i = 0_u32; i < properties.memoryHeapCount; ++i) {
+            const auto& budget = budgets[i];
+            const auto is_device_local = (properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+            stats.heaps.emplace_back(memory_heap_stats_t {
+                .usage = budget.usage,
+                .budget = budget.budget,
+                .allocation_bytes = budget.statistics.allocationBytes,
+                .block_bytes = budget.statistics.blockBytes,
+                .is_device_local = is_device_local,
+            });
+            if (is_device_local && budget.budget != 0) {
+                ratio = std::max(ratio, static_cast<float32>(budget.usage) / static_cast<float32>(budget.budget));
+            }
+        }
+        stats.pressure = memory_pressure_t::e_none;
+        if (ratio >= critical_pressure_ratio) {
+            stats.pressure = memory_pressure_t::e_critical;
+        } else if (ratio >= high_pressure_ratio) {
+            stats.pressure = memory_pressure_t::e_high;
+        }
+
+        auto callbacks = std::vector<std::function<void(memory_pressure_t)>>();
+        const auto pressure = stats.pressure;
+        {
+            auto lock = std::lock_guard(_memory_stats_lock);
+            if (_memory_stats.pressure != pressure) {
+                callbacks = _memory_pressure_callbacks;
+            }
+            _memory_stats = std::move(stats);
+        }
+        if (_memory_pressure.exchange(pressure, std::memory_order_relaxed) != pressure) {
+            IR_LOG_WARN(_logger, "memory pressure changed to {} (device-local usage: {:.1f}%)", as_underlying(pressure), ratio * 100.0f);
+            for (const auto& callback : callbacks) {
+                callback(pressure);
+            }
+        }
     }
 }
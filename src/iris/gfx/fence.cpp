@@ -2,7 +2,9 @@
 #include <iris/gfx/device.hpp>
 
 namespace ir {
-    fence_t::fence_t() noexcept = default;
+    fence_t::fence_t(const device_t& device) noexcept : _device(std::cref(device)) {
+        IR_PROFILE_SCOPED();
+    }
 
     fence_t::~fence_t() noexcept {
         IR_PROFILE_SCOPED();
@@ -16,14 +18,13 @@ namespace ir {
         const std::string& name
     ) noexcept -> arc_ptr<self> {
         IR_PROFILE_SCOPED();
-        auto fence = arc_ptr<self>(new self());
+        auto fence = arc_ptr<self>(new self(device));
         auto fence_info = VkFenceCreateInfo();
         fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
         fence_info.pNext = nullptr;
         fence_info.flags = signaled ? VK_FENCE_CREATE_SIGNALED_BIT : VkFenceCreateFlagBits();
         IR_VULKAN_CHECK(device.logger(), vkCreateFence(device.handle(), &fence_info, nullptr, &fence->_handle));
         IR_LOG_INFO(device.logger(), "fence {} created", fmt::ptr(fence->_handle));
-        fence->_device = device.as_intrusive_ptr();
 
         if (!name.empty()) {
             device.set_debug_name({
@@ -56,7 +57,7 @@ namespace ir {
 
     auto fence_t::device() const noexcept -> const device_t& {
         IR_PROFILE_SCOPED();
-        return *_device;
+        return _device.get();
     }
 
     auto fence_t::is_ready() const noexcept -> bool {
@@ -0,0 +1,81 @@
+#include <iris/gfx/device.hpp>
+#include <iris/gfx/frame_allocator.hpp>
+
+namespace ir {
+    frame_allocator_t::frame_allocator_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    frame_allocator_t::~frame_allocator_t() noexcept = default;
+
+    auto frame_allocator_t::make(device_t& device, const frame_allocator_create_info_t& info) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(
+            info.frames_in_flight >= deletion_queue_t::frames_in_flight,
+            "frame_allocator_t: fewer regions than frames in flight");
+        auto allocator = arc_ptr<self>(new self(device));
+        const auto& limits = device.properties().limits;
+        allocator->_alignment = std::max({
+            16_u64,
+            static_cast<uint64>(limits.minUniformBufferOffsetAlignment),
+            static_cast<uint64>(limits.minStorageBufferOffsetAlignment),
+        });
+        // note: keeps every region start aligned
+        const auto region = (info.capacity + allocator->_alignment - 1) / allocator->_alignment * allocator->_alignment;
+        allocator->_buffer = buffer_t<uint8>::make(device, {
+            .name = info.name,
+            .usage = info.usage,
+            .flags = buffer_flag_t::e_mapped | buffer_flag_t::e_resized,
+            .capacity = region * info.frames_in_flight,
+        });
+        allocator->_region = region;
+        allocator->_info = info;
+        return allocator;
+    }
+
+    auto frame_allocator_t::buffer() const noexcept -> const buffer_t<uint8>& {
+        IR_PROFILE_SCOPED();
+        return *_buffer;
+    }
+
+    auto frame_allocator_t::used() const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        return _head;
+    }
+
+    auto frame_allocator_t::info() const noexcept -> const frame_allocator_create_info_t& {
+        IR_PROFILE_SCOPED();
+        return _info;
+    }
+
+    auto frame_allocator_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    auto frame_allocator_t::allocate(uint64 size, uint64 alignment) noexcept -> frame_allocation_t {
+        IR_PROFILE_SCOPED();
+        alignment = alignment == 0 ? _alignment : alignment;
+        auto lock = std::lock_guard(_lock);
+        _rewind();
+        const auto offset = (_head + alignment - 1) / alignment * alignment;
+        IR_ASSERT(offset + size <= _region, "frame_allocator_t: frame region exhausted");
+        _head = offset + size;
+        const auto base = (_frame % _info.frames_in_flight) * _region + offset;
+        return frame_allocation_t {
+            .slice = _buffer->slice(base, size),
+            .data = _buffer->data() + base,
+            .address = _buffer->address() + base,
+        };
+    }
+
+    auto frame_allocator_t::_rewind() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto frame = device().frame_counter().current();
+        if (frame != _frame) {
+            _frame = frame;
+            _head = 0;
+        }
+    }
+}
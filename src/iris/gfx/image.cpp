@@ -1,8 +1,12 @@
+#include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/defragmenter.hpp>
 #include <iris/gfx/device.hpp>
 #include <iris/gfx/image.hpp>
 #include <iris/gfx/swapchain.hpp>
 #include <iris/gfx/render_pass.hpp>
 
+#include <algorithm>
+
 namespace ir {
     IR_NODISCARD constexpr auto deduce_image_aspect(const image_create_info_t& info) noexcept -> image_aspect_t {
         switch (info.format) {
@@ -22,23 +26,46 @@ namespace ir {
         IR_UNREACHABLE();
     }
 
-    image_view_t::image_view_t(const image_t& image) noexcept : _image(std::cref(image)) {
-        IR_PROFILE_SCOPED();
+    IR_NODISCARD static auto deduce_queue_family(const device_t& device, queue_type_t queue) noexcept -> uint32 {
+        switch (queue) {
+            case queue_type_t::e_graphics: return device.graphics_queue().family();
+            case queue_type_t::e_compute: return device.compute_queue().family();
+            case queue_type_t::e_transfer: return device.transfer_queue().family();
+        }
+        IR_UNREACHABLE();
     }
 
-    image_view_t::~image_view_t() noexcept {
-        IR_PROFILE_SCOPED();
-        IR_LOG_INFO(device().logger(), "image view {} destroyed", fmt::ptr(_handle));
-        vkDestroyImageView(device().handle(), _handle, nullptr);
+    IR_NODISCARD static auto make_image_info(const image_create_info_t& info, const uint32& family) noexcept -> VkImageCreateInfo {
+        auto usage = info.usage;
+        if (info.movable) {
+            usage |= image_usage_t::e_transfer_src | image_usage_t::e_transfer_dst;
+        }
+        auto image_info = VkImageCreateInfo();
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.pNext = nullptr;
+        image_info.flags = as_enum_counterpart(info.flags);
+        // TODO: don't hardcode
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.format = as_enum_counterpart(info.format);
+        image_info.extent = { info.width, info.height, 1 };
+        image_info.mipLevels = info.levels;
+        image_info.arrayLayers = info.layers;
+        image_info.samples = as_enum_counterpart(info.samples);
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.usage = as_enum_counterpart(usage);
+        // TODO: don't hardcode
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.queueFamilyIndexCount = 1;
+        image_info.pQueueFamilyIndices = &family;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        return image_info;
     }
 
-    auto image_view_t::make(
+    IR_NODISCARD static auto make_image_view_info(
         const image_t& image,
-        const image_view_create_info_t& info
-    ) noexcept -> arc_ptr<self> {
-        IR_PROFILE_SCOPED();
-        auto image_view = arc_ptr<self>(new self(image));
-        const auto aspect = deduce_image_aspect(image.info());
+        const image_view_create_info_t& info,
+        image_aspect_t aspect
+    ) noexcept -> VkImageViewCreateInfo {
         auto image_view_info = VkImageViewCreateInfo();
         image_view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         image_view_info.pNext = nullptr;
@@ -59,7 +86,7 @@ namespace ir {
         image_view_info.components.b = as_enum_counterpart(info.swizzle.b);
         image_view_info.components.a = as_enum_counterpart(info.swizzle.a);
         image_view_info.subresourceRange.aspectMask = as_enum_counterpart(aspect);
-         if (info.subresource.level == level_ignored) {
+        if (info.subresource.level == level_ignored) {
             image_view_info.subresourceRange.baseMipLevel = 0;
             image_view_info.subresourceRange.levelCount = image.levels();
         } else {
@@ -73,12 +100,36 @@ namespace ir {
             image_view_info.subresourceRange.baseArrayLayer = info.subresource.layer;
             image_view_info.subresourceRange.layerCount = info.subresource.layer_count;
         }
+        return image_view_info;
+    }
+
+    image_view_t::image_view_t(const image_t& image) noexcept : _image(std::cref(image)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    image_view_t::~image_view_t() noexcept {
+        IR_PROFILE_SCOPED();
+        IR_LOG_INFO(device().logger(), "image view {} destroyed", fmt::ptr(_handle));
+        device().deletion_queue().push([handle = _handle](device_t& device) {
+            vkDestroyImageView(device.handle(), handle, nullptr);
+        });
+    }
+
+    auto image_view_t::make(
+        const image_t& image,
+        const image_view_create_info_t& info
+    ) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto image_view = arc_ptr<self>(new self(image));
+        const auto aspect = deduce_image_aspect(image.info());
+        const auto image_view_info = make_image_view_info(image, info, aspect);
         IR_VULKAN_CHECK(image.device().logger(), vkCreateImageView(image.device().handle(), &image_view_info, nullptr, &image_view->_handle));
         IR_LOG_INFO(image.device().logger(), "image view {} for image {} created", fmt::ptr(image_view->_handle), fmt::ptr(image.handle()));
 
         image_view->_aspect = aspect;
         image_view->_info = info;
-        image_view->_device = image.device().as_intrusive_ptr();
+        image_view->_device = &image.device();
+        image_view->_device_pin = image.device().as_intrusive_ptr();
 
         if (!info.name.empty()) {
             image.device().set_debug_name({
@@ -115,6 +166,23 @@ namespace ir {
         return *_device;
     }
 
+    auto image_view_t::_relocate() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto& image = _image.get();
+        device().deletion_queue().push([handle = _handle](device_t& device) {
+            vkDestroyImageView(device.handle(), handle, nullptr);
+        });
+        const auto image_view_info = make_image_view_info(image, _info, _aspect);
+        IR_VULKAN_CHECK(image.device().logger(), vkCreateImageView(image.device().handle(), &image_view_info, nullptr, &_handle));
+        if (!_info.name.empty()) {
+            image.device().set_debug_name({
+                .type = VK_OBJECT_TYPE_IMAGE_VIEW,
+                .handle = reinterpret_cast<uint64>(_handle),
+                .name = _info.name.c_str(),
+            });
+        }
+    }
+
     image_t::image_t() noexcept = default;
 
     image_t::~image_t() noexcept {
@@ -122,10 +190,17 @@ namespace ir {
         if (_view) {
             _view.reset();
         }
+        if (_is_movable()) {
+            device().defragmenter().untrack(_allocation);
+        }
         if (_allocation) {
-            vmaDestroyImage(device().allocator(), _handle, _allocation);
-        } else if (is_sparsely_bound()) {
-            vkDestroyImage(device().handle(), _handle, nullptr);
+            device().deletion_queue().push([handle = _handle, allocation = _allocation](device_t& device) {
+                vmaDestroyImage(device.allocator(), handle, allocation);
+            });
+        } else if (is_sparsely_bound() || _is_aliased) {
+            device().deletion_queue().push([handle = _handle](device_t& device) {
+                vkDestroyImage(device.handle(), handle, nullptr);
+            });
         }
         IR_LOG_INFO(device().logger(), "image {} destroyed", fmt::ptr(_handle));
     }
@@ -136,36 +211,9 @@ namespace ir {
     ) noexcept -> arc_ptr<self> {
         IR_PROFILE_SCOPED();
         auto image = arc_ptr<self>(new self());
-        const auto family = [&]() {
-            switch (info.queue) {
-                case queue_type_t::e_graphics: return device.graphics_queue().family();
-                case queue_type_t::e_compute: return device.compute_queue().family();
-                case queue_type_t::e_transfer: return device.transfer_queue().family();
-            }
-            IR_UNREACHABLE();
-        }();
-        auto is_sparse = false;
-        auto image_info = VkImageCreateInfo();
-        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        image_info.pNext = nullptr;
-        image_info.flags = as_enum_counterpart(info.flags);
-        if ((info.flags & image_flag_t::e_sparse_binding) == image_flag_t::e_sparse_binding) {
-            is_sparse = true;
-        }
-        // TODO: don't hardcode
-        image_info.imageType = VK_IMAGE_TYPE_2D;
-        image_info.format = as_enum_counterpart(info.format);
-        image_info.extent = { info.width, info.height, 1 };
-        image_info.mipLevels = info.levels;
-        image_info.arrayLayers = info.layers;
-        image_info.samples = as_enum_counterpart(info.samples);
-        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
-        image_info.usage = as_enum_counterpart(info.usage);
-        // TODO: don't hardcode
-        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        image_info.queueFamilyIndexCount = 1;
-        image_info.pQueueFamilyIndices = &family;
-        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        const auto family = deduce_queue_family(device, info.queue);
+        const auto is_sparse = (info.flags & image_flag_t::e_sparse_binding) == image_flag_t::e_sparse_binding;
+        const auto image_info = make_image_info(info, family);
 
         auto format_properties = VkFormatProperties();
         vkGetPhysicalDeviceFormatProperties(device.gpu(), image_info.format, &format_properties);
@@ -180,15 +228,31 @@ namespace ir {
             allocation_info.pool = {};
             allocation_info.pUserData = nullptr;
             allocation_info.priority = 1.0f;
-            IR_VULKAN_CHECK(
-                device.logger(),
-                vmaCreateImage(
+            if (device.memory_pressure() != memory_pressure_t::e_none) {
+                allocation_info.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+            }
+            auto result = vmaCreateImage(
+                device.allocator(),
+                &image_info,
+                &allocation_info,
+                &image->_handle,
+                &image->_allocation,
+                nullptr);
+            if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY) {
+                // note: over budget, let the image spill to any compatible memory type rather than fail
+                IR_LOG_WARN(device.logger(), "image {}x{} does not fit in device memory, relaxing placement", info.width, info.height);
+                allocation_info.flags &= ~VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+                allocation_info.requiredFlags = 0;
+                allocation_info.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                result = vmaCreateImage(
                     device.allocator(),
                     &image_info,
                     &allocation_info,
                     &image->_handle,
                     &image->_allocation,
-                    nullptr));
+                    nullptr);
+            }
+            IR_VULKAN_CHECK(device.logger(), result);
             vkGetImageMemoryRequirements(device.handle(), image->_handle, &image->_requirements);
         } else {
             IR_VULKAN_CHECK(device.logger(), vkCreateImage(device.handle(), &image_info, nullptr, &image->_handle));
@@ -218,7 +282,8 @@ namespace ir {
             image->_sparse_info = image_sparse_req;
         }
         image->_info = info;
-        image->_device = device.as_intrusive_ptr();
+        image->_device = &device;
+        image->_device_pin = device.as_intrusive_ptr();
         if (info.view) {
             auto view_info = *info.view;
             if (!info.name.empty()) {
@@ -231,6 +296,15 @@ namespace ir {
             }
             image->_view = image_view_t::make(*image, *info.view);
         }
+        if (image->_is_movable()) {
+            auto* target = image.get();
+            device.defragmenter().track(image->_allocation, {
+                .move = [target](command_buffer_t& command_buffer, VmaAllocation allocation) {
+                    return target->_relocate(command_buffer, allocation);
+                },
+                .commit = {},
+            });
+        }
         return image;
     }
 
@@ -263,7 +337,8 @@ namespace ir {
             image->_handle = swapchain_images[i];
             image->_allocation = VmaAllocation();
             image->_info = info;
-            image->_device = device.as_intrusive_ptr();
+            image->_device = &device;
+            image->_device_pin = device.as_intrusive_ptr();
             if (info.view) {
                 auto view_info = *info.view;
                 if (!info.name.empty()) {
@@ -298,10 +373,71 @@ namespace ir {
             .usage = info.usage,
             .format = attachment.format,
             .layout = info.layout,
+            .movable = info.movable,
             .view = info.view
         });
     }
 
+    auto image_t::make_aliased(
+        const device_t& device,
+        VmaAllocation memory,
+        uint64 offset,
+        const image_create_info_t& info
+    ) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!info.movable, "image_t: aliased images cannot be movable");
+        auto image = arc_ptr<self>(new self());
+        const auto family = deduce_queue_family(device, info.queue);
+        const auto image_info = make_image_info(info, family);
+        IR_VULKAN_CHECK(
+            device.logger(),
+            vmaCreateAliasingImage2(
+                device.allocator(),
+                memory,
+                offset,
+                &image_info,
+                &image->_handle));
+        vkGetImageMemoryRequirements(device.handle(), image->_handle, &image->_requirements);
+        image->_is_aliased = true;
+        image->_info = info;
+        image->_device = &device;
+        image->_device_pin = device.as_intrusive_ptr();
+        if (!info.name.empty()) {
+            device.set_debug_name({
+                .type = VK_OBJECT_TYPE_IMAGE,
+                .handle = reinterpret_cast<uint64>(image->_handle),
+                .name = info.name.c_str()
+            });
+        }
+        if (info.view) {
+            auto view_info = *info.view;
+            if (!info.name.empty()) {
+                view_info.name = std::format("{}_view", info.name);
+            }
+            image->_view = image_view_t::make(*image, view_info);
+        }
+        return image;
+    }
+
+    auto image_t::query_memory_requirements(
+        const device_t& device,
+        const image_create_info_t& info
+    ) noexcept -> VkMemoryRequirements {
+        IR_PROFILE_SCOPED();
+        const auto family = deduce_queue_family(device, info.queue);
+        const auto image_info = make_image_info(info, family);
+        auto requirements_info = VkDeviceImageMemoryRequirements();
+        requirements_info.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS;
+        requirements_info.pNext = nullptr;
+        requirements_info.pCreateInfo = &image_info;
+        requirements_info.planeAspect = {};
+        auto requirements = VkMemoryRequirements2();
+        requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+        requirements.pNext = nullptr;
+        vkGetDeviceImageMemoryRequirements(device.handle(), &requirements_info, &requirements);
+        return requirements.memoryRequirements;
+    }
+
     auto image_t::handle() const noexcept -> VkImage {
         IR_PROFILE_SCOPED();
         return _handle;
@@ -386,6 +522,45 @@ namespace ir {
         return _info.layout;
     }
 
+    auto image_t::state(uint32 level, uint32 layer) const noexcept -> image_state_t {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(level < _info.levels && layer < _info.layers, "image_t: subresource out of range");
+        auto guard = std::lock_guard(_state_lock);
+        if (_states.empty()) {
+            return {};
+        }
+        return _states[layer * _info.levels + level];
+    }
+
+    auto image_t::resolve(const image_subresource_t& subresource) const noexcept -> image_subresource_t {
+        IR_PROFILE_SCOPED();
+        auto range = image_subresource_t();
+        range.level = subresource.level == level_ignored ? 0 : subresource.level;
+        range.layer = subresource.layer == layer_ignored ? 0 : subresource.layer;
+        range.level_count = subresource.level == level_ignored || subresource.level_count == remaining_levels
+            ? _info.levels - range.level
+            : subresource.level_count;
+        range.layer_count = subresource.layer == layer_ignored || subresource.layer_count == remaining_layers
+            ? _info.layers - range.layer
+            : subresource.layer_count;
+        IR_ASSERT(
+            range.level + range.level_count <= _info.levels && range.layer + range.layer_count <= _info.layers,
+            "image_t: subresource out of range");
+        return range;
+    }
+
+    auto image_t::track(const image_state_t& state, const image_subresource_t& subresource) const noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto range = resolve(subresource);
+        auto guard = std::lock_guard(_state_lock);
+        if (_states.empty()) {
+            _states.resize(_info.levels * _info.layers);
+        }
+        for (auto layer = range.layer; layer < range.layer + range.layer_count; ++layer) {
+            std::fill_n(_states.begin() + layer * _info.levels + range.level, range.level_count, state);
+        }
+    }
+
     auto image_t::info() const noexcept -> const image_create_info_t& {
         IR_PROFILE_SCOPED();
         return _info;
@@ -395,4 +570,168 @@ namespace ir {
         IR_PROFILE_SCOPED();
         return *_device;
     }
+
+    auto image_t::_is_movable() const noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        return _info.movable && _allocation;
+    }
+
+    auto image_t::_relocate(command_buffer_t& command_buffer, VmaAllocation allocation) noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        const auto& device = *_device;
+        const auto family = deduce_queue_family(device, _info.queue);
+        const auto image_info = make_image_info(_info, family);
+        auto handle = VkImage();
+        if (vkCreateImage(device.handle(), &image_info, nullptr, &handle) != VK_SUCCESS) {
+            return false;
+        }
+        if (vmaBindImageMemory(device.allocator(), allocation, handle) != VK_SUCCESS) {
+            vkDestroyImage(device.handle(), handle, nullptr);
+            return false;
+        }
+        const auto aspect = as_enum_counterpart(deduce_image_aspect(_info));
+        const auto make_barrier = [&](VkImage image, uint32 level, uint32 layer, uint32 level_count, uint32 layer_count) {
+            auto barrier = VkImageMemoryBarrier2();
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.pNext = nullptr;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange.aspectMask = aspect;
+            barrier.subresourceRange.baseMipLevel = level;
+            barrier.subresourceRange.levelCount = level_count;
+            barrier.subresourceRange.baseArrayLayer = layer;
+            barrier.subresourceRange.layerCount = layer_count;
+            return barrier;
+        };
+        // note: every subresource leaves the state its last recorded use put it in, untracked ones are undefined
+        auto states = std::vector<image_state_t>();
+        states.reserve(_info.levels * _info.layers);
+        for (auto layer = 0_u32; layer < _info.layers; ++layer) {
+            for (auto level = 0_u32; level < _info.levels; ++level) {
+                states.emplace_back(state(level, layer));
+            }
+        }
+        auto barriers = std::vector<VkImageMemoryBarrier2>();
+        barriers.reserve(states.size() + 1);
+        for (auto layer = 0_u32; layer < _info.layers; ++layer) {
+            for (auto level = 0_u32; level < _info.levels; ++level) {
+                const auto& state = states[layer * _info.levels + level];
+                auto& barrier = barriers.emplace_back(make_barrier(_handle, level, layer, 1, 1));
+                barrier.srcStageMask = as_enum_counterpart(state.stage);
+                barrier.srcAccessMask = as_enum_counterpart(state.access);
+                barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+                barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+                barrier.oldLayout = as_enum_counterpart(state.layout);
+                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            }
+        }
+        {
+            auto& barrier = barriers.emplace_back(make_barrier(handle, 0, 0, _info.levels, _info.layers));
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+            barrier.srcAccessMask = VK_ACCESS_2_NONE;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        }
+        auto dependency_info = VkDependencyInfo();
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.pNext = nullptr;
+        dependency_info.dependencyFlags = {};
+        dependency_info.imageMemoryBarrierCount = barriers.size();
+        dependency_info.pImageMemoryBarriers = barriers.data();
+        vkCmdPipelineBarrier2(command_buffer.handle(), &dependency_info);
+
+        auto regions = std::vector<VkImageCopy>(_info.levels);
+        for (auto level = 0_u32; level < _info.levels; ++level) {
+            auto& region = regions[level];
+            region.srcSubresource.aspectMask = aspect;
+            region.srcSubresource.mipLevel = level;
+            region.srcSubresource.baseArrayLayer = 0;
+            region.srcSubresource.layerCount = _info.layers;
+            region.srcOffset = { 0, 0, 0 };
+            region.dstSubresource = region.srcSubresource;
+            region.dstOffset = { 0, 0, 0 };
+            region.extent = {
+                std::max(_info.width >> level, 1_u32),
+                std::max(_info.height >> level, 1_u32),
+                1,
+            };
+        }
+        vkCmdCopyImage(
+            command_buffer.handle(),
+            _handle,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            handle,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            regions.size(),
+            regions.data());
+
+        // note: only the new image goes back, work recorded earlier on the old one is ahead of the copy
+        barriers.clear();
+        for (auto layer = 0_u32; layer < _info.layers; ++layer) {
+            for (auto level = 0_u32; level < _info.levels; ++level) {
+                const auto& state = states[layer * _info.levels + level];
+                if (state.layout == image_layout_t::e_undefined) {
+                    continue;
+                }
+                auto& barrier = barriers.emplace_back(make_barrier(handle, level, layer, 1, 1));
+                barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+                barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+                barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                barrier.newLayout = as_enum_counterpart(state.layout);
+            }
+        }
+        if (!barriers.empty()) {
+            dependency_info.imageMemoryBarrierCount = barriers.size();
+            dependency_info.pImageMemoryBarriers = barriers.data();
+            vkCmdPipelineBarrier2(command_buffer.handle(), &dependency_info);
+        }
+
+        device.deletion_queue().push([handle = _handle](device_t& device) {
+            vkDestroyImage(device.handle(), handle, nullptr);
+        });
+        _handle = handle;
+        if (!_info.name.empty()) {
+            device.set_debug_name({
+                .type = VK_OBJECT_TYPE_IMAGE,
+                .handle = reinterpret_cast<uint64>(_handle),
+                .name = _info.name.c_str()
+            });
+        }
+        // note: subresources keep the states read before the move, undefined ones were left as copy destinations
+        for (auto& state : states) {
+            if (state.layout == image_layout_t::e_undefined) {
+                state = {
+                    .stage = pipeline_stage_t::e_transfer,
+                    .access = resource_access_t::e_transfer_write,
+                    .layout = image_layout_t::e_transfer_dst_optimal,
+                };
+            }
+        }
+        {
+            auto guard = std::lock_guard(_state_lock);
+            _states = std::move(states);
+        }
+        if (_view) {
+            // note: the old handle is retired through the deletion queue, descriptors pick up the new one through the cache keys
+            _view->_relocate();
+        }
+        return true;
+    }
+
+    auto image_t::_pin(bool is_pinned) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (is_pinned) {
+            _device_pin = _device->as_intrusive_ptr();
+        } else {
+            _device_pin.reset();
+        }
+        if (_view) {
+            _view->_device_pin = _device_pin;
+        }
+    }
 }
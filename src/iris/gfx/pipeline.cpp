@@ -176,8 +176,10 @@ namespace ir {
 
     pipeline_t::~pipeline_t() noexcept {
         IR_PROFILE_SCOPED();
-        vkDestroyPipeline(device().handle(), _handle, nullptr);
-        vkDestroyPipelineLayout(device().handle(), _layout, nullptr);
+        device().deletion_queue().push([handle = _handle, layout = _layout](device_t& device) {
+            vkDestroyPipeline(device.handle(), handle, nullptr);
+            vkDestroyPipelineLayout(device.handle(), layout, nullptr);
+        });
     }
 
     auto pipeline_t::make(device_t& device, const compute_pipeline_create_info_t& info) noexcept -> arc_ptr<self> {
@@ -281,8 +283,8 @@ namespace ir {
                 for (const auto& [binding, desc] : pair_bindings) {
                     bindings[binding] = desc;
                 }
-                if (cache.contains(bindings)) {
-                    descriptor_layout[set] = cache.acquire(bindings);
+                if (auto cached = cache.try_acquire(bindings)) {
+                    descriptor_layout[set] = std::move(*cached);
                 } else {
                     descriptor_layout[set] = cache.insert(bindings, descriptor_layout_t::make(device, {
                         .bindings = bindings
@@ -688,8 +690,8 @@ namespace ir {
                 if (set >= descriptor_layout.size()) {
                     descriptor_layout.resize(set + 1);
                 }
-                if (cache.contains(bindings)) {
-                    descriptor_layout[set] = cache.acquire(bindings);
+                if (auto cached = cache.try_acquire(bindings)) {
+                    descriptor_layout[set] = std::move(*cached);
                 } else {
                     descriptor_layout[set] = cache.insert(bindings, descriptor_layout_t::make(device, {
                         .bindings = bindings
@@ -1141,8 +1143,8 @@ namespace ir {
                 if (set >= descriptor_layout.size()) {
                     descriptor_layout.resize(set + 1);
                 }
-                if (cache.contains(bindings)) {
-                    descriptor_layout[set] = cache.acquire(bindings);
+                if (auto cached = cache.try_acquire(bindings)) {
+                    descriptor_layout[set] = std::move(*cached);
                 } else {
                     descriptor_layout[set] = cache.insert(bindings, descriptor_layout_t::make(device, {
                         .bindings = bindings
@@ -1271,6 +1273,15 @@ namespace ir {
         return std::get<2>(_info);
     }
 
+    auto pipeline_t::dynamic_states() const noexcept -> std::span<const dynamic_state_t> {
+        IR_PROFILE_SCOPED();
+        switch (_info.index()) {
+            case 1: return graphics_info().dynamic_states;
+            case 2: return mesh_info().dynamic_states;
+        }
+        return {};
+    }
+
     auto pipeline_t::device() noexcept -> device_t& {
         IR_PROFILE_SCOPED();
         return *_device;
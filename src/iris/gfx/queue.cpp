@@ -10,7 +10,47 @@
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <utility>
+
 namespace ir {
+    // note: gives the index back when the thread exits, unless its queue is gone by then. the thread-local
+    // map relocates its entries as it grows, a moved-from binding must not give back the index it handed over
+    struct queue_thread_binding_t {
+        std::weak_ptr<queue_thread_pools_t> pools;
+        uint32 index = 0;
+
+        queue_thread_binding_t() noexcept = default;
+
+        queue_thread_binding_t(queue_thread_binding_t&& other) noexcept
+            : pools(std::exchange(other.pools, {})),
+              index(other.index) {}
+
+        auto operator =(queue_thread_binding_t&& other) noexcept -> queue_thread_binding_t& {
+            if (this != &other) {
+                release();
+                pools = std::exchange(other.pools, {});
+                index = other.index;
+            }
+            return *this;
+        }
+
+        IR_DELETE_COPY(queue_thread_binding_t);
+
+        ~queue_thread_binding_t() noexcept {
+            release();
+        }
+
+        auto release() noexcept -> void {
+            if (auto thread_pools = pools.lock()) {
+                auto guard = std::lock_guard(thread_pools->lock);
+                thread_pools->free.emplace_back(index);
+            }
+            pools.reset();
+        }
+    };
+
+    static thread_local auto current_queue_bindings = akl::fast_hash_map<const queue_thread_pools_t*, queue_thread_binding_t>();
+
     template <>
     constexpr auto internal_enum_as_string(queue_type_t type) noexcept -> std::string_view {
         switch (type) {
@@ -27,6 +67,13 @@ namespace ir {
 
     queue_t::~queue_t() noexcept {
         IR_PROFILE_SCOPED();
+        if (_submit_thread.joinable()) {
+            // note: everything pushed before destruction is still handed to the driver
+            _is_running.store(false, std::memory_order_release);
+            _pushed.fetch_add(1, std::memory_order_release);
+            _pushed.notify_one();
+            _submit_thread.join();
+        }
         IR_LOG_INFO(_logger, "queue destroyed");
     }
 
@@ -37,6 +84,8 @@ namespace ir {
         IR_LOG_INFO(logger, "queue initialized (family: {}, index: {})", info.family.family, info.family.index);
 
         queue->_handle = device.fetch_queue(info.family);
+        queue->_owner = std::this_thread::get_id();
+        queue->_thread_pools = std::make_shared<queue_thread_pools_t>();
         queue->_info = info;
         queue->_logger = std::move(logger);
         if (!info.name.empty()) {
@@ -46,6 +95,16 @@ namespace ir {
                 .name = info.name.c_str()
             });
         }
+        if (info.threaded) {
+            queue->_timeline = semaphore_t::make(device, {
+                .name = info.name + "_timeline",
+                .counter = 0,
+                .timeline = true,
+            });
+            queue->_submit_thread = std::thread([queue = queue.get()]() {
+                queue->_work();
+            });
+        }
         return queue;
     }
 
@@ -71,14 +130,34 @@ namespace ir {
 
     auto queue_t::transient_pool(uint32 index) noexcept -> command_pool_t& {
         IR_PROFILE_SCOPED();
+        IR_ASSERT(index == _thread_index(), "queue_t: transient pools are bound to their thread, use transient_pool()");
+        return _transient_pool(index);
+    }
+
+    auto queue_t::transient_pool() noexcept -> command_pool_t& {
+        IR_PROFILE_SCOPED();
+        return _transient_pool(_thread_index());
+    }
+
+    auto queue_t::_transient_pool(uint32 index) noexcept -> command_pool_t& {
+        IR_PROFILE_SCOPED();
+        auto guard = std::lock_guard(_pool_lock);
         if (_transient_pools.empty()) {
             // index = 0 => main thread
             _transient_pools = command_pool_t::make(_device, std::thread::hardware_concurrency() + 1, {
                 .name = "transient_command_pool",
                 .queue = type(),
-                .flags = command_pool_flag_t::e_transient,
+                .flags = command_pool_flag_t::e_transient | command_pool_flag_t::e_reset_command_buffer,
             });
         }
+        // note: more threads than cores get their own pool as well
+        while (index >= _transient_pools.size()) {
+            _transient_pools.emplace_back(command_pool_t::make(_device, {
+                .name = fmt::format("transient_command_pool_{}", _transient_pools.size()),
+                .queue = type(),
+                .flags = command_pool_flag_t::e_transient | command_pool_flag_t::e_reset_command_buffer,
+            }));
+        }
         return *_transient_pools[index];
     }
 
@@ -99,105 +178,83 @@ namespace ir {
 
     auto queue_t::submit(const queue_submit_info_t& info, const fence_t* fence) noexcept -> void {
         IR_PROFILE_SCOPED();
-        auto wait_semaphore_info = std::vector<VkSemaphoreSubmitInfo>();
-        wait_semaphore_info.reserve(info.wait_semaphores.size());
-        auto signal_semaphore_info = std::vector<VkSemaphoreSubmitInfo>();
-        signal_semaphore_info.reserve(info.signal_semaphores.size());
-        auto command_buffer_info = std::vector<VkCommandBufferSubmitInfo>();
-        command_buffer_info.reserve(info.command_buffers.size());
-
-        for (const auto& [semaphore, stage, value] : info.wait_semaphores) {
-            wait_semaphore_info.emplace_back(VkSemaphoreSubmitInfo {
-                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-                .pNext = nullptr,
-                .semaphore = semaphore.get().handle(),
-                .value = value == -1_u64 ? 0 : value,
-                .stageMask = as_enum_counterpart(stage)
+        if (is_threaded()) {
+            _push({
+                .submit = info,
+                .is_flush = true,
+                .fence = fence,
             });
+            return;
         }
+        auto guard = std::lock_guard(_deferred_lock);
+        _append(info);
+        _flush(fence);
+    }
 
-        for (const auto& [semaphore, stage, value] : info.signal_semaphores) {
-            signal_semaphore_info.emplace_back(VkSemaphoreSubmitInfo {
-                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-                .pNext = nullptr,
-                .semaphore = semaphore.get().handle(),
-                .value = value == -1_u64 ? 0 : value,
-                .stageMask = as_enum_counterpart(stage)
+    auto queue_t::defer(const queue_submit_info_t& info) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (is_threaded()) {
+            _push({
+                .submit = info,
             });
+            return;
         }
+        auto guard = std::lock_guard(_deferred_lock);
+        _append(info);
+    }
 
-        for (const auto& command_buffer : info.command_buffers) {
-            command_buffer_info.emplace_back(VkCommandBufferSubmitInfo {
-                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
-                .pNext = nullptr,
-                .commandBuffer = command_buffer.get().handle()
+    auto queue_t::flush(const fence_t* fence) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (is_threaded()) {
+            _push({
+                .is_flush = true,
+                .fence = fence,
             });
+            return;
         }
-
-        auto submit_info = VkSubmitInfo2();
-        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-        submit_info.pNext = nullptr;
-        submit_info.flags = {};
-        submit_info.waitSemaphoreInfoCount = wait_semaphore_info.size();
-        submit_info.pWaitSemaphoreInfos = wait_semaphore_info.data();
-        submit_info.commandBufferInfoCount = command_buffer_info.size();
-        submit_info.pCommandBufferInfos = command_buffer_info.data();
-        submit_info.signalSemaphoreInfoCount = signal_semaphore_info.size();
-        submit_info.pSignalSemaphoreInfos = signal_semaphore_info.data();
-        auto guard = std::lock_guard(_lock);
-        IR_VULKAN_CHECK(_device.get().logger(), vkQueueSubmit2(_handle, 1, &submit_info, fence ? fence->handle() : nullptr));
+        auto guard = std::lock_guard(_deferred_lock);
+        _flush(fence);
     }
 
     auto queue_t::submit(const std::function<void(command_buffer_t&)>& record) noexcept -> void {
         IR_PROFILE_SCOPED();
-        auto command_buffer = command_buffer_t::make(transient_pool(0), {});
-        auto fence = fence_t::make(device(), false);
-        command_buffer->begin();
-        record(*command_buffer);
-        command_buffer->end();
+        const auto index = _thread_index();
+        auto one_shot = _acquire_one_shot(index);
+        auto& command_buffer = *one_shot.command_buffer;
+        auto& fence = *one_shot.fence;
+        // note: the pool allows individual resets, begin() discards the previous recording
+        command_buffer.begin();
+        record(command_buffer);
+        command_buffer.end();
         submit({
-            .command_buffers = { std::cref(*command_buffer) },
+            .command_buffers = { std::cref(command_buffer) },
             .wait_semaphores = {},
             .signal_semaphores = {},
-        }, fence.get());
-        fence->wait();
+        }, &fence);
+        fence.wait();
+        fence.reset();
+        _release_one_shot(index, std::move(one_shot));
     }
 
     auto queue_t::present(const queue_present_info_t& info) noexcept -> bool {
         IR_PROFILE_SCOPED();
-        auto wait_semaphore_info = std::vector<VkSemaphore>();
-        wait_semaphore_info.reserve(info.wait_semaphores.size());
-        for (const auto& semaphore : info.wait_semaphores) {
-            wait_semaphore_info.emplace_back(semaphore.get().handle());
-        }
-
-        const auto swapchain = info.swapchain.get().handle();
-        auto present_info = VkPresentInfoKHR();
-        present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        present_info.pNext = nullptr;
-        present_info.waitSemaphoreCount = wait_semaphore_info.size();
-        present_info.pWaitSemaphores = wait_semaphore_info.data();
-        present_info.swapchainCount = 1;
-        present_info.pSwapchains = &swapchain;
-        present_info.pImageIndices = &info.image;
-        present_info.pResults = nullptr;
-        auto guard = std::lock_guard(_lock);
-        const auto result = vkQueuePresentKHR(_handle, &present_info);
-        if (result == VK_ERROR_OUT_OF_DATE_KHR ||
-            result == VK_ERROR_SURFACE_LOST_KHR ||
-            result == VK_SUBOPTIMAL_KHR
-        ) {
-            return true;
-        }
-        if (result != VK_SUCCESS) {
-            IR_VULKAN_CHECK(_device.get().logger(), result);
-            IR_UNREACHABLE();
+        if (is_threaded()) {
+            // note: acquire_next_image() waits for this present to reach the driver before it touches the swapchain
+            info.swapchain.get()._pending_presents.fetch_add(1, std::memory_order_acq_rel);
+            _push({
+                .present = info,
+            });
+            return _is_outdated.exchange(false, std::memory_order_acq_rel);
         }
-        return false;
+        // note: the semaphores waited on may be signaled by deferred submissions
+        auto guard = std::lock_guard(_deferred_lock);
+        _flush(nullptr);
+        return _present(info);
     }
 
     auto queue_t::bind_sparse(const queue_bind_sparse_info_t& info, const fence_t* fence) noexcept -> void {
         IR_PROFILE_SCOPED();
+        _settle();
         auto semaphore_wait_values = std::vector<uint64>(info.wait_semaphores.size());
         auto semaphore_signal_values = std::vector<uint64>(info.signal_semaphores.size());
 
@@ -205,19 +262,66 @@ namespace ir {
         wait_semaphore_info.reserve(info.wait_semaphores.size());
         for (auto index = 0_u32; const auto& [semaphore, stage, value] : info.wait_semaphores) {
             wait_semaphore_info.emplace_back(semaphore.get().handle());
-            semaphore_wait_values[index] = value == -1_u64 ? 0 : value;
+            semaphore_wait_values[index++] = value == -1_u64 ? 0 : value;
         }
 
         auto signal_semaphore_info = std::vector<VkSemaphore>();
         signal_semaphore_info.reserve(info.signal_semaphores.size());
         for (auto index = 0_u32; const auto& [semaphore, stage, value] : info.signal_semaphores) {
             signal_semaphore_info.emplace_back(semaphore.get().handle());
-            semaphore_signal_values[index] = value == -1_u64 ? 0 : value;
+            semaphore_signal_values[index++] = value == -1_u64 ? 0 : value;
+        }
+
+        const auto make_memory_bind = [](const sparse_memory_bind_t& sparse_bind) {
+            auto bind = VkSparseMemoryBind();
+            bind.resourceOffset = sparse_bind.offset;
+            bind.size = sparse_bind.size;
+            bind.memory = sparse_bind.buffer.memory;
+            bind.memoryOffset = sparse_bind.buffer.offset;
+            bind.flags = {};
+            return bind;
+        };
+
+        auto buffer_bind_info = std::vector<VkSparseBufferMemoryBindInfo>();
+        buffer_bind_info.reserve(info.buffer_binds.size());
+        auto buffer_memory_bind_infos = std::vector<std::vector<VkSparseMemoryBind>>();
+        buffer_memory_bind_infos.reserve(info.buffer_binds.size());
+        for (const auto& buffer_bind : info.buffer_binds) {
+            auto& buffer_memory_bind_info = buffer_memory_bind_infos.emplace_back(std::vector<VkSparseMemoryBind>());
+            buffer_memory_bind_info.reserve(buffer_bind.bindings.size());
+            for (const auto& sparse_bind : buffer_bind.bindings) {
+                buffer_memory_bind_info.emplace_back(make_memory_bind(sparse_bind));
+            }
+
+            auto bind_info = VkSparseBufferMemoryBindInfo();
+            bind_info.buffer = buffer_bind.buffer;
+            bind_info.bindCount = buffer_memory_bind_info.size();
+            bind_info.pBinds = buffer_memory_bind_info.data();
+            buffer_bind_info.emplace_back(bind_info);
+        }
+
+        auto image_opaque_bind_info = std::vector<VkSparseImageOpaqueMemoryBindInfo>();
+        image_opaque_bind_info.reserve(info.image_opaque_binds.size());
+        auto image_opaque_memory_bind_infos = std::vector<std::vector<VkSparseMemoryBind>>();
+        image_opaque_memory_bind_infos.reserve(info.image_opaque_binds.size());
+        for (const auto& image_bind : info.image_opaque_binds) {
+            auto& image_opaque_memory_bind_info = image_opaque_memory_bind_infos.emplace_back(std::vector<VkSparseMemoryBind>());
+            image_opaque_memory_bind_info.reserve(image_bind.bindings.size());
+            for (const auto& sparse_bind : image_bind.bindings) {
+                image_opaque_memory_bind_info.emplace_back(make_memory_bind(sparse_bind));
+            }
+
+            auto bind_info = VkSparseImageOpaqueMemoryBindInfo();
+            bind_info.image = image_bind.image.get().handle();
+            bind_info.bindCount = image_opaque_memory_bind_info.size();
+            bind_info.pBinds = image_opaque_memory_bind_info.data();
+            image_opaque_bind_info.emplace_back(bind_info);
         }
 
         auto image_bind_info = std::vector<VkSparseImageMemoryBindInfo>();
         image_bind_info.reserve(info.image_binds.size());
         auto image_memory_bind_infos = std::vector<std::vector<VkSparseImageMemoryBind>>();
+        image_memory_bind_infos.reserve(info.image_binds.size());
         for (const auto& image_bind : info.image_binds) {
             const auto& image = image_bind.image.get();
             auto& image_memory_bind_info = image_memory_bind_infos.emplace_back(std::vector<VkSparseImageMemoryBind>());
@@ -257,13 +361,12 @@ namespace ir {
         bind_sparse_info.pNext = &semaphore_submit_info;
         bind_sparse_info.waitSemaphoreCount = wait_semaphore_info.size();
         bind_sparse_info.pWaitSemaphores = wait_semaphore_info.data();
-        // TODO: sparse binding buffers / opaque memory binds
-        bind_sparse_info.bufferBindCount = 0;
-        bind_sparse_info.pBufferBinds = nullptr;
+        bind_sparse_info.bufferBindCount = buffer_bind_info.size();
+        bind_sparse_info.pBufferBinds = buffer_bind_info.data();
+        bind_sparse_info.imageOpaqueBindCount = image_opaque_bind_info.size();
+        bind_sparse_info.pImageOpaqueBinds = image_opaque_bind_info.data();
         bind_sparse_info.imageBindCount = image_bind_info.size();
         bind_sparse_info.pImageBinds = image_bind_info.data();
-        bind_sparse_info.imageOpaqueBindCount = 0;
-        bind_sparse_info.pImageOpaqueBinds = nullptr;
         bind_sparse_info.signalSemaphoreCount = signal_semaphore_info.size();
         bind_sparse_info.pSignalSemaphores = signal_semaphore_info.data();
         auto guard = std::lock_guard(_lock);
@@ -272,7 +375,267 @@ namespace ir {
 
     auto queue_t::wait_idle() noexcept -> void {
         IR_PROFILE_SCOPED();
+        _settle();
         auto guard = std::lock_guard(_lock);
         IR_VULKAN_CHECK(_device.get().logger(), vkQueueWaitIdle(_handle));
     }
+
+    auto queue_t::is_threaded() const noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        return _timeline != nullptr;
+    }
+
+    auto queue_t::timeline() const noexcept -> const semaphore_t& {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(is_threaded(), "queue_t: timeline() requires a threaded queue");
+        return *_timeline;
+    }
+
+    auto queue_t::timeline_value() const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        return _flushed.load(std::memory_order_acquire);
+    }
+
+    auto queue_t::drain() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (!is_threaded()) {
+            return;
+        }
+        // note: work queued ahead of ours was reserved earlier, so processing this many covers it
+        const auto target = _reserved.load(std::memory_order_acquire);
+        auto processed = _processed.load(std::memory_order_acquire);
+        while (processed < target) {
+            _processed.wait(processed, std::memory_order_acquire);
+            processed = _processed.load(std::memory_order_acquire);
+        }
+    }
+
+    auto queue_t::_thread_index() noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        const auto thread = std::this_thread::get_id();
+        if (thread == _owner) {
+            return 0;
+        }
+        auto& binding = current_queue_bindings[_thread_pools.get()];
+        if (binding.pools.lock() == _thread_pools) {
+            return binding.index;
+        }
+        // note: a pool is only ever recorded from the thread it is bound to, an exited thread's pool is reused
+        auto guard = std::lock_guard(_thread_pools->lock);
+        auto index = 0_u32;
+        if (!_thread_pools->free.empty()) {
+            index = _thread_pools->free.back();
+            _thread_pools->free.pop_back();
+        } else {
+            index = ++_thread_pools->count;
+        }
+        binding.pools = _thread_pools;
+        binding.index = index;
+        return index;
+    }
+
+    auto queue_t::_acquire_one_shot(uint32 index) noexcept -> one_shot_t {
+        IR_PROFILE_SCOPED();
+        {
+            auto guard = std::lock_guard(_pool_lock);
+            if (index < _one_shots.size() && !_one_shots[index].empty()) {
+                auto one_shot = std::move(_one_shots[index].back());
+                _one_shots[index].pop_back();
+                return one_shot;
+            }
+        }
+        return one_shot_t {
+            .command_buffer = command_buffer_t::make(_transient_pool(index), {}),
+            .fence = fence_t::make(device(), false),
+        };
+    }
+
+    auto queue_t::_release_one_shot(uint32 index, one_shot_t one_shot) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto guard = std::lock_guard(_pool_lock);
+        if (index >= _one_shots.size()) {
+            _one_shots.resize(index + 1);
+        }
+        _one_shots[index].emplace_back(std::move(one_shot));
+    }
+
+    auto queue_t::_append(const queue_submit_info_t& info) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto make_semaphore_info = [](const queue_semaphore_stage_t& semaphore) {
+            auto semaphore_info = VkSemaphoreSubmitInfo();
+            semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            semaphore_info.pNext = nullptr;
+            semaphore_info.semaphore = semaphore.semaphore.get().handle();
+            semaphore_info.value = semaphore.value == -1_u64 ? 0 : semaphore.value;
+            semaphore_info.stageMask = as_enum_counterpart(semaphore.stage);
+            semaphore_info.deviceIndex = 0;
+            return semaphore_info;
+        };
+        _deferred.emplace_back(deferred_submit_t {
+            .first_wait = static_cast<uint32>(_deferred_waits.size()),
+            .wait_count = static_cast<uint32>(info.wait_semaphores.size()),
+            .first_command_buffer = static_cast<uint32>(_deferred_command_buffers.size()),
+            .command_buffer_count = static_cast<uint32>(info.command_buffers.size()),
+            .first_signal = static_cast<uint32>(_deferred_signals.size()),
+            .signal_count = static_cast<uint32>(info.signal_semaphores.size()),
+        });
+        for (const auto& semaphore : info.wait_semaphores) {
+            _deferred_waits.emplace_back(make_semaphore_info(semaphore));
+        }
+        for (const auto& semaphore : info.signal_semaphores) {
+            _deferred_signals.emplace_back(make_semaphore_info(semaphore));
+        }
+        for (const auto& command_buffer : info.command_buffers) {
+            auto command_buffer_info = VkCommandBufferSubmitInfo();
+            command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+            command_buffer_info.pNext = nullptr;
+            command_buffer_info.commandBuffer = command_buffer.get().handle();
+            command_buffer_info.deviceMask = 0;
+            _deferred_command_buffers.emplace_back(command_buffer_info);
+        }
+    }
+
+    auto queue_t::_flush(const fence_t* fence) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (_deferred.empty() && !fence) {
+            return;
+        }
+        // note: pointers are taken once every submission is appended, the arrays no longer grow
+        _submit_infos.clear();
+        for (const auto& deferred : _deferred) {
+            auto submit_info = VkSubmitInfo2();
+            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+            submit_info.pNext = nullptr;
+            submit_info.flags = {};
+            submit_info.waitSemaphoreInfoCount = deferred.wait_count;
+            submit_info.pWaitSemaphoreInfos = _deferred_waits.data() + deferred.first_wait;
+            submit_info.commandBufferInfoCount = deferred.command_buffer_count;
+            submit_info.pCommandBufferInfos = _deferred_command_buffers.data() + deferred.first_command_buffer;
+            submit_info.signalSemaphoreInfoCount = deferred.signal_count;
+            submit_info.pSignalSemaphoreInfos = _deferred_signals.data() + deferred.first_signal;
+            _submit_infos.emplace_back(submit_info);
+        }
+        {
+            auto guard = std::lock_guard(_lock);
+            IR_VULKAN_CHECK(
+                _device.get().logger(),
+                vkQueueSubmit2(_handle, _submit_infos.size(), _submit_infos.data(), fence ? fence->handle() : nullptr));
+        }
+        _deferred.clear();
+        _deferred_waits.clear();
+        _deferred_signals.clear();
+        _deferred_command_buffers.clear();
+    }
+
+    auto queue_t::_present(const queue_present_info_t& info) noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        auto wait_semaphore_info = std::vector<VkSemaphore>();
+        wait_semaphore_info.reserve(info.wait_semaphores.size());
+        for (const auto& semaphore : info.wait_semaphores) {
+            wait_semaphore_info.emplace_back(semaphore.get().handle());
+        }
+
+        const auto swapchain = info.swapchain.get().handle();
+        auto present_info = VkPresentInfoKHR();
+        present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        present_info.pNext = nullptr;
+        present_info.waitSemaphoreCount = wait_semaphore_info.size();
+        present_info.pWaitSemaphores = wait_semaphore_info.data();
+        present_info.swapchainCount = 1;
+        present_info.pSwapchains = &swapchain;
+        present_info.pImageIndices = &info.image;
+        present_info.pResults = nullptr;
+        auto guard = std::lock_guard(_lock);
+        auto swapchain_guard = std::lock_guard(info.swapchain.get()._lock);
+        const auto result = vkQueuePresentKHR(_handle, &present_info);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR ||
+            result == VK_ERROR_SURFACE_LOST_KHR ||
+            result == VK_SUBOPTIMAL_KHR
+        ) {
+            return true;
+        }
+        if (result != VK_SUCCESS) {
+            IR_VULKAN_CHECK(_device.get().logger(), result);
+            IR_UNREACHABLE();
+        }
+        return false;
+    }
+
+    auto queue_t::_settle() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        // note: the submit thread only appends deferred work, whatever it left behind is flushed here
+        drain();
+        auto guard = std::lock_guard(_deferred_lock);
+        _flush(nullptr);
+    }
+
+    auto queue_t::_push(work_t work) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        _reserved.fetch_add(1, std::memory_order_acq_rel);
+        if (work.is_flush || work.present) {
+            // note: values are handed out in push order, so the submit thread signals them in increasing order
+            auto guard = std::lock_guard(_flush_lock);
+            const auto value = _flushed.load(std::memory_order_relaxed) + 1;
+            work.value = value;
+            _works.push(std::move(work));
+            _flushed.store(value, std::memory_order_release);
+        } else {
+            _works.push(std::move(work));
+        }
+        _pushed.fetch_add(1, std::memory_order_release);
+        _pushed.notify_one();
+    }
+
+    auto queue_t::_process(const work_t& work) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto guard = std::lock_guard(_deferred_lock);
+        if (work.submit) {
+            _append(*work.submit);
+        }
+        if (!work.is_flush && !work.present) {
+            return;
+        }
+        // note: the timeline counts flushes and presents, each one covers everything deferred before it
+        _append({
+            .command_buffers = {},
+            .wait_semaphores = {},
+            .signal_semaphores = { {
+                .semaphore = std::cref(*_timeline),
+                .stage = pipeline_stage_t::e_all_commands,
+                .value = work.value,
+            } },
+        });
+        _flush(work.fence);
+        if (work.present) {
+            if (_present(*work.present)) {
+                _is_outdated.store(true, std::memory_order_release);
+            }
+            auto& pending = work.present->swapchain.get()._pending_presents;
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+            pending.notify_all();
+        }
+    }
+
+    auto queue_t::_work() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto work = work_t();
+        while (true) {
+            const auto pushed = _pushed.load(std::memory_order_acquire);
+            auto is_empty = true;
+            while (_works.pop(work)) {
+                _process(work);
+                work = {};
+                is_empty = false;
+                _processed.fetch_add(1, std::memory_order_acq_rel);
+                _processed.notify_all();
+            }
+            if (is_empty && !_is_running.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (is_empty) {
+                // note: a producer between its exchange and its link bumps _pushed once linked
+                _pushed.wait(pushed, std::memory_order_acquire);
+            }
+        }
+    }
 }
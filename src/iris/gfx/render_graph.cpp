@@ -0,0 +1,757 @@
+#include <iris/gfx/device.hpp>
+#include <iris/gfx/command_pool.hpp>
+#include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/deletion_queue.hpp>
+#include <iris/gfx/fence.hpp>
+#include <iris/gfx/queue.hpp>
+#include <iris/gfx/semaphore.hpp>
+#include <iris/gfx/render_graph.hpp>
+
+#include <algorithm>
+
+namespace ir {
+    IR_NODISCARD static auto other_slot(uint32 slot) noexcept -> uint32 {
+        return 1 - slot;
+    }
+
+    IR_NODISCARD static auto is_covered(pipeline_stage_t stage, resource_access_t access, const render_graph_usage_t& usage) noexcept -> bool {
+        return (stage & usage.stage) == usage.stage && (access & usage.access) == usage.access;
+    }
+
+    render_graph_builder_t::render_graph_builder_t(render_graph_t& graph, uint32 pass) noexcept
+        : _graph(std::ref(graph)),
+          _pass(pass) {
+        IR_PROFILE_SCOPED();
+    }
+
+    auto render_graph_builder_t::read(render_graph_resource_t resource, const render_graph_usage_t& usage) noexcept -> self& {
+        IR_PROFILE_SCOPED();
+        auto& graph = _graph.get();
+        IR_ASSERT(resource.index < graph._resources.size(), "render_graph_builder_t: invalid resource");
+        graph._passes[_pass].accesses.emplace_back(render_graph_t::access_t {
+            .resource = resource.index,
+            .usage = usage,
+            .is_write = false,
+        });
+        return *this;
+    }
+
+    auto render_graph_builder_t::write(render_graph_resource_t resource, const render_graph_usage_t& usage) noexcept -> self& {
+        IR_PROFILE_SCOPED();
+        auto& graph = _graph.get();
+        IR_ASSERT(resource.index < graph._resources.size(), "render_graph_builder_t: invalid resource");
+        graph._passes[_pass].accesses.emplace_back(render_graph_t::access_t {
+            .resource = resource.index,
+            .usage = usage,
+            .is_write = true,
+        });
+        return *this;
+    }
+
+    render_graph_t::render_graph_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    render_graph_t::~render_graph_t() noexcept {
+        IR_PROFILE_SCOPED();
+        // note: pooled command buffers may still be executing
+        for (auto slot = 0_u32; slot < slot_count; ++slot) {
+            _timelines[slot]->wait(_values[slot]);
+        }
+    }
+
+    auto render_graph_t::make(device_t& device, const render_graph_create_info_t& info) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto graph = arc_ptr<self>(new self(device));
+        for (auto slot = 0_u32; slot < slot_count; ++slot) {
+            graph->_timelines[slot] = semaphore_t::make(device, {
+                .name = info.name + (slot == graphics_slot ? "_graphics_timeline" : "_compute_timeline"),
+                .counter = 0,
+                .timeline = true,
+            });
+        }
+        graph->_pools.resize(deletion_queue_t::frames_in_flight);
+        graph->_command_buffers.resize(deletion_queue_t::frames_in_flight);
+        graph->_frame_values.resize(deletion_queue_t::frames_in_flight);
+        for (auto& pools : graph->_pools) {
+            for (auto slot = 0_u32; slot < slot_count; ++slot) {
+                pools[slot] = command_pool_t::make(device, {
+                    .name = info.name + "_command_pool",
+                    .queue = slot == graphics_slot ? queue_type_t::e_graphics : queue_type_t::e_compute,
+                    .flags = command_pool_flag_t::e_transient,
+                });
+            }
+        }
+        graph->_info = info;
+        return graph;
+    }
+
+    auto render_graph_t::import_image(const image_t& image, const render_graph_usage_t& initial, const render_graph_usage_t& final) noexcept -> render_graph_resource_t {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!_is_compiled, "render_graph_t: cannot add resources after compile()");
+        auto family = device().graphics_queue().family();
+        if (image.info().queue == queue_type_t::e_compute) {
+            family = device().compute_queue().family();
+        } else if (image.info().queue == queue_type_t::e_transfer) {
+            family = device().transfer_queue().family();
+        }
+        _resources.emplace_back(resource_t {
+            .info = image.info(),
+            .image = &image,
+            .is_image = true,
+            .initial = initial,
+            .final = final,
+            .family = family,
+        });
+        return { static_cast<uint32>(_resources.size() - 1) };
+    }
+
+    auto render_graph_t::import_buffer(const buffer_info_t& buffer, const render_graph_usage_t& initial) noexcept -> render_graph_resource_t {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!_is_compiled, "render_graph_t: cannot add resources after compile()");
+        _resources.emplace_back(resource_t {
+            .info = transient_buffer_create_info_t(),
+            .buffer = buffer,
+            .initial = initial,
+        });
+        return { static_cast<uint32>(_resources.size() - 1) };
+    }
+
+    auto render_graph_t::create_image(const image_create_info_t& info) noexcept -> render_graph_resource_t {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!_is_compiled, "render_graph_t: cannot add resources after compile()");
+        _resources.emplace_back(resource_t {
+            .info = info,
+            .is_image = true,
+            .is_transient = true,
+        });
+        return { static_cast<uint32>(_resources.size() - 1) };
+    }
+
+    auto render_graph_t::create_buffer(const transient_buffer_create_info_t& info) noexcept -> render_graph_resource_t {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!_is_compiled, "render_graph_t: cannot add resources after compile()");
+        _resources.emplace_back(resource_t {
+            .info = info,
+            .is_transient = true,
+        });
+        return { static_cast<uint32>(_resources.size() - 1) };
+    }
+
+    auto render_graph_t::add_pass(const render_graph_pass_info_t& info, const setup_function_t& setup, execute_function_t execute) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!_is_compiled, "render_graph_t: cannot add passes after compile()");
+        _passes.emplace_back(pass_t {
+            .info = info,
+            .execute = std::move(execute),
+        });
+        auto builder = render_graph_builder_t(*this, _passes.size() - 1);
+        if (setup) {
+            setup(builder);
+        }
+    }
+
+    auto render_graph_t::compile() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!_is_compiled, "render_graph_t: already compiled, reset() first");
+        _stats = {
+            .passes = static_cast<uint32>(_passes.size()),
+        };
+        _cull();
+        _place();
+        _schedule();
+        _is_compiled = true;
+    }
+
+    auto render_graph_t::execute(const render_graph_execute_info_t& info) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(_is_compiled, "render_graph_t: execute() requires compile()");
+        const auto frame = device().frame_counter().current();
+        const auto frame_index = frame % deletion_queue_t::frames_in_flight;
+        if (frame != _frame) {
+            // note: the frame slot comes around again, its command buffers must be done before the pools reset
+            for (auto slot = 0_u32; slot < slot_count; ++slot) {
+                _timelines[slot]->wait(_frame_values[frame_index][slot]);
+                _pools[frame_index][slot]->reset();
+            }
+            _used = {};
+            _frame = frame;
+        }
+
+        auto first_graphics = -1_u32;
+        auto first_compute = -1_u32;
+        auto last_graphics = -1_u32;
+        for (const auto batch : _submissions) {
+            if (_batches[batch].slot == graphics_slot) {
+                if (first_graphics == -1_u32) {
+                    first_graphics = batch;
+                }
+                last_graphics = batch;
+            } else if (first_compute == -1_u32) {
+                first_compute = batch;
+            }
+        }
+
+        const auto base = _values;
+        for (const auto index : _submissions) {
+            const auto& batch = _batches[index];
+            auto& command_buffer = _command_buffer(batch.slot);
+            command_buffer.begin();
+            if (index == first_graphics) {
+                command_buffer.pipeline_barrier(_pending);
+            }
+            for (const auto pass : batch.passes) {
+                const auto& current = _passes[pass];
+                command_buffer.begin_debug_marker(current.info.name);
+                if (_transient != nullptr) {
+                    _transient->begin_pass(command_buffer, pass);
+                }
+                command_buffer.pipeline_barrier(current.before);
+                if (current.execute) {
+                    current.execute(command_buffer);
+                }
+                command_buffer.pipeline_barrier(current.after);
+                command_buffer.end_debug_marker();
+            }
+            if (index == last_graphics) {
+                command_buffer.pipeline_barrier(_tail);
+            }
+            command_buffer.end();
+
+            auto submit_info = queue_submit_info_t();
+            submit_info.command_buffers = { std::cref(command_buffer) };
+            const auto other = other_slot(batch.slot);
+            auto wait = batch.waits[other] != 0 ? base[other] + batch.waits[other] : 0;
+            // note: transient memory and imported resources are shared with the previous frame, async compute must not overtake its graphics work
+            if (index == first_compute && _is_async_shared) {
+                wait = std::max(wait, base[graphics_slot]);
+            }
+            // note: the previous frame's detached passes finish before this frame's graphics work starts
+            if (index == first_graphics) {
+                wait = std::max(wait, _pending_value);
+            }
+            if (wait != 0) {
+                submit_info.wait_semaphores.emplace_back(queue_semaphore_stage_t {
+                    .semaphore = std::cref(*_timelines[other]),
+                    .stage = pipeline_stage_t::e_all_commands,
+                    .value = wait,
+                });
+            }
+            if (index == first_graphics) {
+                submit_info.wait_semaphores.insert(submit_info.wait_semaphores.end(), info.wait_semaphores.begin(), info.wait_semaphores.end());
+            }
+            submit_info.signal_semaphores.emplace_back(queue_semaphore_stage_t {
+                .semaphore = std::cref(*_timelines[batch.slot]),
+                .stage = pipeline_stage_t::e_all_commands,
+                .value = base[batch.slot] + batch.signal,
+            });
+            if (index == last_graphics) {
+                submit_info.signal_semaphores.insert(submit_info.signal_semaphores.end(), info.signal_semaphores.begin(), info.signal_semaphores.end());
+            }
+            _queue(batch.slot).defer(submit_info);
+        }
+        // note: one vkQueueSubmit2 per queue and frame, timeline waits may be submitted before their signals
+        if (&_queue(compute_slot) != &_queue(graphics_slot)) {
+            _queue(compute_slot).flush();
+        }
+        _queue(graphics_slot).flush(info.fence);
+        for (auto slot = 0_u32; slot < slot_count; ++slot) {
+            _values[slot] += _counts[slot];
+        }
+        _frame_values[frame_index] = _values;
+        _pending = std::move(_acquires);
+        _pending_value = _stats.detached != 0 ? _values[compute_slot] : 0;
+        _acquires.clear();
+    }
+
+    auto render_graph_t::reset() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        _resources.clear();
+        _passes.clear();
+        _batches.clear();
+        _open_batches = { -1_u32, -1_u32 };
+        _submissions.clear();
+        _tail.clear();
+        _acquires.clear();
+        _counts = {};
+        _is_compiled = false;
+    }
+
+    auto render_graph_t::image(render_graph_resource_t resource) const noexcept -> const image_t& {
+        IR_PROFILE_SCOPED();
+        const auto& current = _resources[resource.index];
+        IR_ASSERT(current.is_image, "render_graph_t: resource is not an image");
+        if (current.is_transient) {
+            IR_ASSERT(current.transient.index != -1_u32, "render_graph_t: transient image is not used by any pass");
+            return _transient->image(current.transient);
+        }
+        return *current.image;
+    }
+
+    auto render_graph_t::buffer(render_graph_resource_t resource) const noexcept -> buffer_info_t {
+        IR_PROFILE_SCOPED();
+        const auto& current = _resources[resource.index];
+        IR_ASSERT(!current.is_image, "render_graph_t: resource is not a buffer");
+        if (current.is_transient) {
+            IR_ASSERT(current.transient.index != -1_u32, "render_graph_t: transient buffer is not used by any pass");
+            return _transient->buffer(current.transient);
+        }
+        return current.buffer;
+    }
+
+    auto render_graph_t::stats() const noexcept -> const render_graph_stats_t& {
+        IR_PROFILE_SCOPED();
+        return _stats;
+    }
+
+    auto render_graph_t::info() const noexcept -> const render_graph_create_info_t& {
+        IR_PROFILE_SCOPED();
+        return _info;
+    }
+
+    auto render_graph_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    auto render_graph_t::_cull() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto is_async = &device().compute_queue() != &device().graphics_queue();
+        auto is_needed = std::vector<bool>(_resources.size(), false);
+        // note: walk backwards, a pass is alive when something alive or outside of the frame consumes its writes
+        for (auto index = static_cast<int64>(_passes.size()) - 1; index >= 0; --index) {
+            auto& pass = _passes[index];
+            pass.is_alive = pass.info.is_side_effect || std::any_of(pass.accesses.begin(), pass.accesses.end(), [&](const access_t& access) {
+                return access.is_write && (!_resources[access.resource].is_transient || is_needed[access.resource]);
+            });
+            if (!pass.is_alive) {
+                _stats.culled++;
+                continue;
+            }
+            for (const auto& access : pass.accesses) {
+                if (!access.is_write) {
+                    is_needed[access.resource] = true;
+                }
+            }
+            pass.slot = graphics_slot;
+            if (is_async && pass.info.queue == queue_type_t::e_compute) {
+                pass.slot = compute_slot;
+                _stats.async++;
+                if (pass.info.is_detached) {
+                    _stats.detached++;
+                }
+            }
+        }
+    }
+
+    auto render_graph_t::_place() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto first = -1_u32;
+        auto last = 0_u32;
+        for (auto index = 0_u32; index < _passes.size(); ++index) {
+            const auto& pass = _passes[index];
+            if (!pass.is_alive) {
+                continue;
+            }
+            first = std::min(first, index);
+            last = index;
+            for (const auto& access : pass.accesses) {
+                auto& resource = _resources[access.resource];
+                resource.lifetime.first = std::min(resource.lifetime.first, index);
+                resource.lifetime.last = std::max(resource.lifetime.last, index);
+                resource.is_async |= pass.slot == compute_slot;
+            }
+        }
+
+        auto declarations = std::vector<std::pair<std::variant<image_create_info_t, transient_buffer_create_info_t>, transient_lifetime_t>>();
+        _is_async_shared = false;
+        // note: imported resources carry no ownership from the previous frame, only its graphics timeline orders them
+        for (const auto& resource : _resources) {
+            if (resource.is_async && !resource.is_transient && resource.family != _family(compute_slot)) {
+                _is_async_shared = true;
+            }
+        }
+        for (auto& resource : _resources) {
+            if (!resource.is_transient || resource.lifetime.first == -1_u32) {
+                continue;
+            }
+            // note: the queues run concurrently, memory touched by async compute is never aliased
+            if (resource.is_async) {
+                resource.lifetime = { first, last };
+                _is_async_shared = true;
+            }
+            declarations.emplace_back(resource.info, resource.lifetime);
+        }
+        if (_transient == nullptr || declarations != _declarations) {
+            if (_transient == nullptr) {
+                _transient = transient_allocator_t::make(device(), {
+                    .name = _info.name + "_transient_allocator",
+                });
+            } else {
+                _transient->reset();
+            }
+            for (const auto& declaration : declarations) {
+                std::visit([&](const auto& info) {
+                    (void)_transient->declare(info, declaration.second);
+                }, declaration.first);
+            }
+            if (!declarations.empty()) {
+                _transient->compile();
+            }
+            _declarations = std::move(declarations);
+        }
+        // note: declarations are made in resource order, the allocator indices follow it
+        auto index = 0_u32;
+        for (auto& resource : _resources) {
+            if (resource.is_transient && resource.lifetime.first != -1_u32) {
+                resource.transient = { index++ };
+            }
+        }
+    }
+
+    auto render_graph_t::_schedule() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto states = std::vector<state_t>(_resources.size());
+        for (auto index = 0_u32; index < _resources.size(); ++index) {
+            const auto& resource = _resources[index];
+            auto& state = states[index];
+            if (!resource.is_transient) {
+                state.write_stage = resource.initial.stage;
+                state.write_access = resource.initial.access;
+                state.layout = resource.initial.layout;
+                state.family = resource.is_image ? resource.family : queue_family_ignored;
+                continue;
+            }
+            if (resource.lifetime.first == -1_u32) {
+                continue;
+            }
+            // note: begin_pass() transitions the image to its declared layout at the start of its lifetime,
+            // the first use also orders against the previous frame's use of the same memory
+            const auto& first = _passes[resource.lifetime.first];
+            state.write_stage = pipeline_stage_t::e_all_commands;
+            state.write_access = resource_access_t::e_memory_write;
+            state.layout = resource.is_image ? std::get<image_create_info_t>(resource.info).layout : image_layout_t::e_undefined;
+            state.family = _family(first.slot);
+            state.writer = resource.lifetime.first;
+        }
+
+        for (auto index = 0_u32; index < _passes.size(); ++index) {
+            auto& pass = _passes[index];
+            if (!pass.is_alive) {
+                continue;
+            }
+            for (const auto& access : pass.accesses) {
+                _depend(states[access.resource], access.is_write, pass.slot);
+            }
+            auto& batch = _open(pass.slot);
+            batch.passes.emplace_back(index);
+            pass.batch = &batch - _batches.data();
+            for (const auto& access : pass.accesses) {
+                _use(states[access.resource], _resources[access.resource], access, index, pass.slot, pass.before);
+            }
+        }
+
+        // note: final layouts are applied at the end of the last graphics submission,
+        // images last used by async compute are handed back to the graphics queue there as well
+        const auto tail = static_cast<uint32>(_passes.size());
+        for (auto index = 0_u32; index < _resources.size(); ++index) {
+            const auto& resource = _resources[index];
+            auto& state = states[index];
+            if (resource.is_transient || !resource.is_image) {
+                continue;
+            }
+            const auto is_moved =
+                state.family != resource.family &&
+                state.family == _family(compute_slot) &&
+                state.layout != image_layout_t::e_undefined;
+            if (resource.final.layout == image_layout_t::e_undefined && !is_moved) {
+                continue;
+            }
+            const auto producer = _last(state, compute_slot);
+            if (is_moved && producer != -1_u32 && _passes[producer].info.is_detached) {
+                _release(state, resource, producer);
+                continue;
+            }
+            const auto access = access_t {
+                .resource = index,
+                .usage = resource.final,
+                .is_write = false,
+            };
+            _depend(state, true, graphics_slot);
+            _use(state, resource, access, tail, graphics_slot, _tail);
+        }
+
+        // note: the frame ends on the graphics queue once async compute has finished, except for detached passes
+        _close(compute_slot);
+        auto joined = 0_u64;
+        for (const auto& batch : _batches) {
+            if (batch.slot != compute_slot) {
+                continue;
+            }
+            const auto is_attached = std::any_of(batch.passes.begin(), batch.passes.end(), [&](uint32 pass) {
+                return !_passes[pass].info.is_detached;
+            });
+            if (is_attached) {
+                joined = std::max(joined, batch.signal);
+            }
+        }
+        if (joined != 0) {
+            auto* batch = &_open(graphics_slot);
+            if (!batch->passes.empty() && batch->waits[compute_slot] < joined) {
+                _close(graphics_slot);
+                batch = &_open(graphics_slot);
+            }
+            batch->waits[compute_slot] = std::max(batch->waits[compute_slot], joined);
+        }
+        _open(graphics_slot);
+        _close(graphics_slot);
+    }
+
+    auto render_graph_t::_use(
+        state_t& state,
+        const resource_t& resource,
+        const access_t& access,
+        uint32 pass,
+        uint32 slot,
+        barrier_batch_t& barriers
+    ) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto& usage = access.usage;
+        const auto other = other_slot(slot);
+        const auto family = _family(slot);
+        const auto is_writer_known = state.writer < _passes.size();
+        const auto is_cross = access.is_write
+            ? _last(state, other) != -1_u32
+            : is_writer_known && _passes[state.writer].slot == other;
+        // note: the initial state of imported resources comes from earlier submissions on this queue
+        const auto is_local = access.is_write
+            ? _last(state, slot) != -1_u32 || (state.writer == -1_u32 && state.write_stage != pipeline_stage_t::e_none)
+            : (is_writer_known && _passes[state.writer].slot == slot) || state.writer == -1_u32;
+        const auto new_layout = resource.is_image && usage.layout != image_layout_t::e_undefined ? usage.layout : state.layout;
+        const auto is_layout_change = resource.is_image && new_layout != state.layout;
+        const auto is_tracked = resource.is_image || resource.is_transient;
+        const auto is_transfer =
+            is_tracked &&
+            state.family != queue_family_ignored &&
+            state.family != family &&
+            (!resource.is_image || state.layout != image_layout_t::e_undefined);
+
+        auto source_stage = state.write_stage;
+        auto source_access = state.write_access;
+        if (access.is_write || is_layout_change) {
+            source_stage |= state.read_stage;
+        }
+        auto is_needed = is_layout_change || is_transfer;
+        if (!is_needed && is_local && source_stage != pipeline_stage_t::e_none) {
+            is_needed = access.is_write || !is_covered(state.read_stage, state.read_access, usage);
+        }
+        // note: the semaphore between the queues already orders the other queue's accesses
+        if (is_cross && !is_local) {
+            source_stage = pipeline_stage_t::e_all_commands;
+            source_access = resource_access_t::e_none;
+        }
+
+        if (is_needed) {
+            auto source_family = queue_family_ignored;
+            auto dest_family = queue_family_ignored;
+            const auto producer = _last(state, other);
+            if (is_transfer && producer != -1_u32) {
+                source_family = state.family;
+                dest_family = family;
+                // note: ownership moves with a release on the producing queue and a matching acquire here
+                if (resource.is_image) {
+                    _passes[producer].after.image_barrier({
+                        .image = std::cref(*(resource.is_transient ? &_transient->image(resource.transient) : resource.image)),
+                        .source_stage = state.write_stage | state.read_stage,
+                        .source_access = state.write_access,
+                        .old_layout = state.layout,
+                        .new_layout = new_layout,
+                        .source_family = source_family,
+                        .dest_family = dest_family,
+                    });
+                } else {
+                    _passes[producer].after.buffer_barrier({
+                        .buffer = _transient->buffer(resource.transient),
+                        .source_stage = state.write_stage | state.read_stage,
+                        .source_access = state.write_access,
+                        .source_family = source_family,
+                        .dest_family = dest_family,
+                    });
+                }
+                source_stage = pipeline_stage_t::e_none;
+                source_access = resource_access_t::e_none;
+            }
+            if (resource.is_image) {
+                barriers.image_barrier({
+                    .image = std::cref(*(resource.is_transient ? &_transient->image(resource.transient) : resource.image)),
+                    .source_stage = source_stage,
+                    .dest_stage = usage.stage,
+                    .source_access = source_access,
+                    .dest_access = usage.access,
+                    .old_layout = state.layout,
+                    .new_layout = new_layout,
+                    .source_family = source_family,
+                    .dest_family = dest_family,
+                });
+            } else if (source_family != dest_family) {
+                barriers.buffer_barrier({
+                    .buffer = _transient->buffer(resource.transient),
+                    .dest_stage = usage.stage,
+                    .dest_access = usage.access,
+                    .source_family = source_family,
+                    .dest_family = dest_family,
+                });
+            } else {
+                barriers.memory_barrier({
+                    .source_stage = source_stage,
+                    .dest_stage = usage.stage,
+                    .source_access = source_access,
+                    .dest_access = usage.access,
+                });
+            }
+            _stats.barriers++;
+        }
+
+        if (access.is_write || is_layout_change) {
+            // note: a transition is a write, later readers depend on the pass that made it
+            state.write_stage = usage.stage;
+            if (access.is_write) {
+                state.write_access = usage.access;
+            }
+            state.read_stage = access.is_write ? pipeline_stage_t::e_none : usage.stage;
+            state.read_access = access.is_write ? resource_access_t::e_none : usage.access;
+            state.writer = pass;
+            state.readers = { -1_u32, -1_u32 };
+        } else {
+            state.read_stage |= usage.stage;
+            state.read_access |= usage.access;
+            state.readers[slot] = pass;
+        }
+        state.layout = new_layout;
+        if (is_tracked) {
+            state.family = family;
+        }
+    }
+
+    auto render_graph_t::_depend(const state_t& state, bool is_write, uint32 slot) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto other = other_slot(slot);
+        auto producer = -1_u32;
+        if (is_write) {
+            producer = _last(state, other);
+        } else if (state.writer < _passes.size() && _passes[state.writer].slot == other) {
+            producer = state.writer;
+        }
+        if (producer == -1_u32) {
+            return;
+        }
+        // note: the producer's submission must exist before this queue can wait on its signal
+        const auto index = _passes[producer].batch;
+        if (!_batches[index].is_closed) {
+            _close(other);
+        }
+        const auto signal = _batches[index].signal;
+        auto* batch = &_open(slot);
+        if (batch->waits[other] >= signal) {
+            return;
+        }
+        if (!batch->passes.empty()) {
+            _close(slot);
+            batch = &_open(slot);
+        }
+        batch->waits[other] = signal;
+    }
+
+    auto render_graph_t::_last(const state_t& state, uint32 slot) const noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        auto last = state.readers[slot];
+        if (state.writer < _passes.size() && _passes[state.writer].slot == slot) {
+            last = last == -1_u32 ? state.writer : std::max(last, state.writer);
+        }
+        return last;
+    }
+
+    auto render_graph_t::_open(uint32 slot) noexcept -> batch_t& {
+        IR_PROFILE_SCOPED();
+        if (_open_batches[slot] == -1_u32) {
+            _batches.emplace_back(batch_t {
+                .slot = slot,
+            });
+            _open_batches[slot] = _batches.size() - 1;
+        }
+        return _batches[_open_batches[slot]];
+    }
+
+    auto render_graph_t::_close(uint32 slot) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (_open_batches[slot] == -1_u32) {
+            return;
+        }
+        auto& batch = _batches[_open_batches[slot]];
+        batch.signal = ++_counts[slot];
+        batch.is_closed = true;
+        _submissions.emplace_back(_open_batches[slot]);
+        _open_batches[slot] = -1_u32;
+        _stats.submissions++;
+    }
+
+    auto render_graph_t::_release(state_t& state, const resource_t& resource, uint32 producer) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto family = _family(graphics_slot);
+        const auto layout = resource.final.layout != image_layout_t::e_undefined ? resource.final.layout : state.layout;
+        auto stage = resource.final.stage;
+        auto access = resource.final.access;
+        if (stage == pipeline_stage_t::e_none) {
+            stage = pipeline_stage_t::e_all_commands;
+            access = resource_access_t::e_memory_read | resource_access_t::e_memory_write;
+        }
+        // note: released right after the producer, acquired once the next frame has waited on the compute timeline
+        _passes[producer].after.image_barrier({
+            .image = std::cref(*resource.image),
+            .source_stage = state.write_stage | state.read_stage,
+            .source_access = state.write_access,
+            .old_layout = state.layout,
+            .new_layout = layout,
+            .source_family = state.family,
+            .dest_family = family,
+        });
+        _acquires.image_barrier({
+            .image = std::cref(*resource.image),
+            .dest_stage = stage,
+            .dest_access = access,
+            .old_layout = state.layout,
+            .new_layout = layout,
+            .source_family = state.family,
+            .dest_family = family,
+        });
+        state.layout = layout;
+        state.family = family;
+        _stats.barriers += 2;
+    }
+
+    auto render_graph_t::_family(uint32 slot) const noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        return _queue(slot).family();
+    }
+
+    auto render_graph_t::_queue(uint32 slot) const noexcept -> queue_t& {
+        IR_PROFILE_SCOPED();
+        if (slot == compute_slot) {
+            return device().compute_queue();
+        }
+        return device().graphics_queue();
+    }
+
+    auto render_graph_t::_command_buffer(uint32 slot) noexcept -> command_buffer_t& {
+        IR_PROFILE_SCOPED();
+        const auto index = _frame % deletion_queue_t::frames_in_flight;
+        auto& command_buffers = _command_buffers[index][slot];
+        if (_used[slot] == command_buffers.size()) {
+            command_buffers.emplace_back(command_buffer_t::make(*_pools[index][slot], {
+                .name = _info.name + "_command_buffer",
+            }));
+        }
+        return *command_buffers[_used[slot]++];
+    }
+}
@@ -0,0 +1,147 @@
+#include <iris/gfx/device.hpp>
+#include <iris/gfx/resource_pool.hpp>
+
+#include <algorithm>
+
+namespace ir {
+    resource_pool_t::resource_pool_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    resource_pool_t::~resource_pool_t() noexcept {
+        IR_PROFILE_SCOPED();
+        clear();
+    }
+
+    auto resource_pool_t::make(device_t& device) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        return arc_ptr<self>(new self(device));
+    }
+
+    auto resource_pool_t::acquire(const image_create_info_t& info) noexcept -> arc_ptr<image_t> {
+        IR_PROFILE_SCOPED();
+        {
+            auto lock = std::lock_guard(_lock);
+            auto image = _acquire(_images, info);
+            if (image != nullptr) {
+                image->_pin(true);
+                return image;
+            }
+        }
+        return image_t::make(device(), info);
+    }
+
+    auto resource_pool_t::acquire(const buffer_create_info_t& info) noexcept -> arc_ptr<buffer_t<uint8>> {
+        IR_PROFILE_SCOPED();
+        {
+            auto lock = std::lock_guard(_lock);
+            auto buffer = _acquire(_buffers, info);
+            if (buffer != nullptr) {
+                buffer->_pin(true);
+                if ((info.flags & buffer_flag_t::e_resized) != buffer_flag_t::e_resized) {
+                    buffer->clear();
+                }
+                return buffer;
+            }
+        }
+        return buffer_t<uint8>::make(device(), info);
+    }
+
+    auto resource_pool_t::release(arc_ptr<image_t> image) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(image->count() == 1, "resource_pool_t: released image is still referenced");
+        const auto frame = device().frame_counter().current() + deletion_queue_t::frames_in_flight;
+        // note: the device owns the pool, a pooled image pinning it would keep both alive
+        image->_pin(false);
+        auto lock = std::lock_guard(_lock);
+        auto& bucket = _images[image->info()];
+        bucket.emplace_back(entry_t<image_t> {
+            .resource = std::move(image),
+            .frame = frame,
+        });
+        _stats.pooled++;
+    }
+
+    auto resource_pool_t::release(arc_ptr<buffer_t<uint8>> buffer) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(buffer->count() == 1, "resource_pool_t: released buffer is still referenced");
+        const auto frame = device().frame_counter().current() + deletion_queue_t::frames_in_flight;
+        buffer->_pin(false);
+        auto lock = std::lock_guard(_lock);
+        // note: keyed by the current info, growth through reserve() updates the capacity
+        auto& bucket = _buffers[buffer->info()];
+        bucket.emplace_back(entry_t<buffer_t<uint8>> {
+            .resource = std::move(buffer),
+            .frame = frame,
+        });
+        _stats.pooled++;
+    }
+
+    auto resource_pool_t::tick() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        const auto frame = device().frame_counter().current();
+        auto lock = std::lock_guard(_lock);
+        _trim(_images, frame);
+        _trim(_buffers, frame);
+    }
+
+    auto resource_pool_t::clear() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        _images.clear();
+        _buffers.clear();
+        _stats.pooled = 0;
+    }
+
+    auto resource_pool_t::stats() const noexcept -> resource_pool_stats_t {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        return _stats;
+    }
+
+    auto resource_pool_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    template <typename K, typename T>
+    auto resource_pool_t::_acquire(bucket_map<K, T>& buckets, const K& info) noexcept -> arc_ptr<T> {
+        IR_PROFILE_SCOPED();
+        const auto frame = device().frame_counter().current();
+        auto bucket = buckets.find(info);
+        if (bucket != buckets.end()) {
+            auto& entries = bucket->second;
+            // note: entries are appended in release order, the front retires first
+            if (!entries.empty() && entries.front().frame <= frame) {
+                auto resource = std::move(entries.front().resource);
+                entries.erase(entries.begin());
+                _stats.hits++;
+                _stats.pooled--;
+                return resource;
+            }
+        }
+        _stats.misses++;
+        return {};
+    }
+
+    template <typename K, typename T>
+    auto resource_pool_t::_trim(bucket_map<K, T>& buckets, uint64 frame) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        for (auto bucket = buckets.begin(); bucket != buckets.end();) {
+            auto& entries = bucket->second;
+            const auto middle = std::stable_partition(entries.begin(), entries.end(), [&](const entry_t<T>& entry) {
+                return entry.frame + idle_frames > frame;
+            });
+            const auto trimmed = static_cast<uint64>(std::distance(middle, entries.end()));
+            entries.erase(middle, entries.end());
+            _stats.trimmed += trimmed;
+            _stats.pooled -= trimmed;
+            if (entries.empty()) {
+                bucket = buckets.erase(bucket);
+            } else {
+                ++bucket;
+            }
+        }
+    }
+}
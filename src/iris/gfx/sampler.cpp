@@ -15,8 +15,8 @@ namespace ir {
     auto sampler_t::make(device_t& device, const sampler_create_info_t& info) noexcept -> arc_ptr<self> {
         IR_PROFILE_SCOPED();
         auto& cache = device.cache<self>();
-        if (cache.contains(info)) {
-            return cache.acquire(info);
+        if (auto sampler = cache.try_acquire(info)) {
+            return std::move(*sampler);
         }
 
         auto sampler = arc_ptr<self>(new self(device));
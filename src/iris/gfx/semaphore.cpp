@@ -2,7 +2,9 @@
 #include <iris/gfx/semaphore.hpp>
 
 namespace ir {
-    semaphore_t::semaphore_t() noexcept = default;
+    semaphore_t::semaphore_t(const device_t& device) noexcept : _device(std::cref(device)) {
+        IR_PROFILE_SCOPED();
+    }
 
     semaphore_t::~semaphore_t() noexcept {
         IR_PROFILE_SCOPED();
@@ -12,7 +14,7 @@ namespace ir {
 
     auto semaphore_t::make(const device_t& device, const semaphore_create_info_t& info) noexcept -> arc_ptr<self> {
         IR_PROFILE_SCOPED();
-        auto semaphore = arc_ptr<self>(new self());
+        auto semaphore = arc_ptr<self>(new self(device));
         auto timeline_semaphore_info = VkSemaphoreTypeCreateInfo();
         timeline_semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
         timeline_semaphore_info.pNext = nullptr;
@@ -30,7 +32,6 @@ namespace ir {
 
         semaphore->_counter = info.counter;
         semaphore->_is_timeline = info.timeline;
-        semaphore->_device = device.as_intrusive_ptr();
         if (!info.name.empty()) {
             device.set_debug_name({
                 .type = VK_OBJECT_TYPE_SEMAPHORE,
@@ -71,7 +72,28 @@ namespace ir {
 
     auto semaphore_t::device() const noexcept -> const device_t& {
         IR_PROFILE_SCOPED();
-        return *_device;
+        return _device.get();
+    }
+
+    auto semaphore_t::value() const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(_is_timeline, "semaphore_t: value() requires a timeline semaphore");
+        auto value = 0_u64;
+        IR_VULKAN_CHECK(device().logger(), vkGetSemaphoreCounterValue(device().handle(), _handle, &value));
+        return value;
+    }
+
+    auto semaphore_t::wait(uint64 value, uint64 timeout) const noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(_is_timeline, "semaphore_t: wait() requires a timeline semaphore");
+        auto wait_info = VkSemaphoreWaitInfo();
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.pNext = nullptr;
+        wait_info.flags = {};
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &_handle;
+        wait_info.pValues = &value;
+        IR_VULKAN_CHECK(device().logger(), vkWaitSemaphores(device().handle(), &wait_info, timeout));
     }
 
     auto semaphore_t::increment(uint64 x) noexcept -> uint64 {
@@ -219,6 +219,12 @@ namespace ir {
 
     auto swapchain_t::acquire_next_image(const semaphore_t& semaphore) const noexcept -> std::pair<uint32, bool> {
         IR_PROFILE_SCOPED();
+        auto pending = _pending_presents.load(std::memory_order_acquire);
+        while (pending != 0) {
+            _pending_presents.wait(pending, std::memory_order_acquire);
+            pending = _pending_presents.load(std::memory_order_acquire);
+        }
+        auto guard = std::lock_guard(_lock);
         auto index = uint32();
         const auto result = vkAcquireNextImageKHR(device().handle(), _handle, -1_u64, semaphore.handle(), nullptr, &index);
         if (result == VK_ERROR_OUT_OF_DATE_KHR ||
@@ -4,6 +4,7 @@
 #include <iris/gfx/sampler.hpp>
 #include <iris/gfx/command_buffer.hpp>
 #include <iris/gfx/texture.hpp>
+#include <iris/gfx/upload_service.hpp>
 
 #include <mio/mmap.hpp>
 
@@ -38,12 +39,6 @@ namespace ir {
             }();
             IR_ASSERT(!ktxTexture2_TranscodeBasis(ktx, transcode_format, KTX_TF_HIGH_QUALITY), "transcode failure");
         }
-        auto staging = buffer_t<uint8>::make(device, {
-            .usage = buffer_usage_t::e_transfer_src,
-            .flags = buffer_flag_t::e_mapped,
-            .capacity = ktx->dataSize
-        });
-        staging->insert(0, ktx->dataSize, ktx->pData);
         auto image = image_t::make(device, {
             .name = info.name,
             .width = ktx->baseWidth,
@@ -60,33 +55,23 @@ namespace ir {
             ktx->dataSize,
             as_string(image->format()));
 
-        // TODO: use the transfer queue
-        device.graphics_queue().submit([&](command_buffer_t& cmd) {
-            cmd.image_barrier({
-                .image = *image,
-                .source_stage = pipeline_stage_t::e_none,
-                .dest_stage = pipeline_stage_t::e_transfer,
-                .source_access = resource_access_t::e_none,
-                .dest_access = resource_access_t::e_transfer_write,
-                .old_layout = image_layout_t::e_undefined,
-                .new_layout = image_layout_t::e_transfer_dst_optimal,
-            });
-            for (auto i = 0_u32; i < ktx->numLevels; ++i) {
-                auto offset = 0_u64;
-                ktxTexture_GetImageOffset(ktxTexture(ktx), i, 0, 0, &offset);
-                cmd.copy_buffer_to_image(staging->slice(offset), *image, {
+        auto regions = std::vector<upload_image_region_t>();
+        regions.reserve(ktx->numLevels);
+        for (auto i = 0_u32; i < ktx->numLevels; ++i) {
+            auto offset = 0_u64;
+            ktxTexture_GetImageOffset(ktxTexture(ktx), i, 0, 0, &offset);
+            regions.emplace_back(upload_image_region_t {
+                .offset = offset,
+                .subresource = {
                     .level = i,
-                });
-            }
-            cmd.image_barrier({
-                .image = *image,
-                .source_stage = pipeline_stage_t::e_transfer,
-                .dest_stage = pipeline_stage_t::e_fragment_shader,
-                .source_access = resource_access_t::e_transfer_write,
-                .dest_access = resource_access_t::e_shader_read,
-                .old_layout = image_layout_t::e_transfer_dst_optimal,
-                .new_layout = image_layout_t::e_shader_read_only_optimal,
+                },
             });
+        }
+        texture->_upload = device.upload_service().upload(upload_image_info_t {
+            .image = std::cref(*image),
+            .data = std::span(ktx->pData, ktx->dataSize),
+            .regions = std::move(regions),
+            .layout = image_layout_t::e_shader_read_only_optimal,
         });
         texture->_image = std::move(image);
         texture->_info = info;
@@ -107,6 +92,11 @@ namespace ir {
         return *_image;
     }
 
+    auto texture_t::upload() const noexcept -> upload_handle_t {
+        IR_PROFILE_SCOPED();
+        return _upload;
+    }
+
     auto texture_t::info() const noexcept -> image_info_t {
         IR_PROFILE_SCOPED();
         return {
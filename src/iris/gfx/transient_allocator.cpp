@@ -0,0 +1,314 @@
+#include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/device.hpp>
+#include <iris/gfx/transient_allocator.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace ir {
+    IR_NODISCARD static auto is_overlapping(const transient_lifetime_t& a, const transient_lifetime_t& b) noexcept -> bool {
+        return a.first <= b.last && b.first <= a.last;
+    }
+
+    IR_NODISCARD static auto align_up(uint64 value, uint64 alignment) noexcept -> uint64 {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    transient_allocator_t::transient_allocator_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    transient_allocator_t::~transient_allocator_t() noexcept {
+        IR_PROFILE_SCOPED();
+        reset();
+    }
+
+    auto transient_allocator_t::make(device_t& device, const transient_allocator_create_info_t& info) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto allocator = arc_ptr<self>(new self(device));
+        allocator->_info = info;
+        return allocator;
+    }
+
+    auto transient_allocator_t::declare(const image_create_info_t& info, transient_lifetime_t lifetime) noexcept -> transient_resource_t {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!is_compiled(), "transient_allocator_t: cannot declare resources after compile()");
+        IR_ASSERT(lifetime.first <= lifetime.last, "transient_allocator_t: invalid lifetime");
+        IR_ASSERT(!info.movable, "transient_allocator_t: transient images cannot be movable");
+        _resources.emplace_back(resource_t {
+            .info = info,
+            .lifetime = lifetime,
+            .requirements = image_t::query_memory_requirements(device(), info),
+        });
+        return { static_cast<uint32>(_resources.size() - 1) };
+    }
+
+    auto transient_allocator_t::declare(const transient_buffer_create_info_t& info, transient_lifetime_t lifetime) noexcept -> transient_resource_t {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!is_compiled(), "transient_allocator_t: cannot declare resources after compile()");
+        IR_ASSERT(lifetime.first <= lifetime.last, "transient_allocator_t: invalid lifetime");
+        auto usage = info.usage;
+        if (device().is_supported(device_feature_t::e_buffer_device_address)) {
+            usage |= buffer_usage_t::e_shader_device_address;
+        }
+        auto buffer_info = VkBufferCreateInfo();
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.pNext = nullptr;
+        buffer_info.flags = {};
+        buffer_info.size = info.size;
+        buffer_info.usage = as_enum_counterpart(usage);
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        auto requirements_info = VkDeviceBufferMemoryRequirements();
+        requirements_info.sType = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS;
+        requirements_info.pNext = nullptr;
+        requirements_info.pCreateInfo = &buffer_info;
+        auto requirements = VkMemoryRequirements2();
+        requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+        requirements.pNext = nullptr;
+        vkGetDeviceBufferMemoryRequirements(device().handle(), &requirements_info, &requirements);
+        auto declared = info;
+        declared.usage = usage;
+        _resources.emplace_back(resource_t {
+            .info = std::move(declared),
+            .lifetime = lifetime,
+            .requirements = requirements.memoryRequirements,
+        });
+        return { static_cast<uint32>(_resources.size() - 1) };
+    }
+
+    auto transient_allocator_t::compile() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(!is_compiled(), "transient_allocator_t: already compiled");
+        if (_resources.empty()) {
+            return;
+        }
+        auto& device = this->device();
+        const auto size = _place();
+        auto requirements = VkMemoryRequirements();
+        requirements.size = size;
+        requirements.alignment = 0;
+        requirements.memoryTypeBits = ~0_u32;
+        for (const auto& resource : _resources) {
+            requirements.alignment = std::max(requirements.alignment, resource.requirements.alignment);
+            requirements.memoryTypeBits &= resource.requirements.memoryTypeBits;
+        }
+        IR_ASSERT(requirements.memoryTypeBits != 0, "transient_allocator_t: declared resources share no memory type");
+
+        auto allocation_info = VmaAllocationCreateInfo();
+        allocation_info.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        allocation_info.usage = VMA_MEMORY_USAGE_UNKNOWN;
+        allocation_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        allocation_info.preferredFlags = 0;
+        allocation_info.memoryTypeBits = 0;
+        allocation_info.pool = {};
+        allocation_info.pUserData = nullptr;
+        allocation_info.priority = 1.0f;
+        IR_VULKAN_CHECK(device.logger(), vmaAllocateMemory(device.allocator(), &requirements, &allocation_info, &_memory, nullptr));
+        if (!_info.name.empty()) {
+            vmaSetAllocationName(device.allocator(), _memory, _info.name.c_str());
+        }
+
+        const auto is_bda_supported = device.is_supported(device_feature_t::e_buffer_device_address);
+        auto passes = 0_u32;
+        for (auto i = 0_u32; i < _resources.size(); ++i) {
+            auto& resource = _resources[i];
+            if (const auto* info = std::get_if<image_create_info_t>(&resource.info)) {
+                resource.image = image_t::make_aliased(device, _memory, resource.offset, *info);
+            } else {
+                const auto& info = std::get<transient_buffer_create_info_t>(resource.info);
+                auto buffer_info = VkBufferCreateInfo();
+                buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+                buffer_info.pNext = nullptr;
+                buffer_info.flags = {};
+                buffer_info.size = info.size;
+                buffer_info.usage = as_enum_counterpart(info.usage);
+                buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                IR_VULKAN_CHECK(
+                    device.logger(),
+                    vmaCreateAliasingBuffer2(device.allocator(), _memory, resource.offset, &buffer_info, &resource.buffer));
+                if (is_bda_supported) {
+                    auto bda_info = VkBufferDeviceAddressInfo();
+                    bda_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+                    bda_info.pNext = nullptr;
+                    bda_info.buffer = resource.buffer;
+                    resource.address = vkGetBufferDeviceAddress(device.handle(), &bda_info);
+                }
+                if (!info.name.empty()) {
+                    device.set_debug_name({
+                        .type = VK_OBJECT_TYPE_BUFFER,
+                        .handle = reinterpret_cast<uint64>(resource.buffer),
+                        .name = info.name.c_str(),
+                    });
+                }
+            }
+            passes = std::max(passes, resource.lifetime.last + 1);
+        }
+
+        _starts.assign(passes, {});
+        for (auto i = 0_u32; i < _resources.size(); ++i) {
+            auto& resource = _resources[i];
+            _starts[resource.lifetime.first].emplace_back(i);
+            for (const auto& other : _resources) {
+                const auto is_earlier = other.lifetime.last < resource.lifetime.first;
+                const auto is_sharing =
+                    other.offset < resource.offset + resource.requirements.size &&
+                    resource.offset < other.offset + other.requirements.size;
+                if (is_earlier && is_sharing) {
+                    resource.is_aliasing = true;
+                    break;
+                }
+            }
+        }
+        _stats.resources = _resources.size();
+        _stats.allocated = size;
+        _stats.requested = std::accumulate(_resources.begin(), _resources.end(), 0_u64, [](uint64 sum, const resource_t& resource) {
+            return sum + resource.requirements.size;
+        });
+        IR_LOG_INFO(
+            device.logger(),
+            "transient allocator {}: {} resources in {} bytes ({} bytes without aliasing)",
+            _info.name,
+            _stats.resources,
+            _stats.allocated,
+            _stats.requested);
+    }
+
+    auto transient_allocator_t::reset() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto& deletion_queue = device().deletion_queue();
+        for (auto& resource : _resources) {
+            if (resource.buffer) {
+                deletion_queue.push([buffer = resource.buffer](device_t& device) {
+                    vkDestroyBuffer(device.handle(), buffer, nullptr);
+                });
+            }
+        }
+        // note: images retire their handles through the same queue before the memory is freed
+        _resources.clear();
+        _starts.clear();
+        if (_memory) {
+            deletion_queue.push([memory = _memory](device_t& device) {
+                vmaFreeMemory(device.allocator(), memory);
+            });
+            _memory = {};
+        }
+        _stats = {};
+    }
+
+    auto transient_allocator_t::image(transient_resource_t resource) const noexcept -> const image_t& {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(is_compiled(), "transient_allocator_t: not compiled");
+        return *_resources[resource.index].image;
+    }
+
+    auto transient_allocator_t::buffer(transient_resource_t resource) const noexcept -> buffer_info_t {
+        IR_PROFILE_SCOPED();
+        IR_ASSERT(is_compiled(), "transient_allocator_t: not compiled");
+        const auto& buffer = _resources[resource.index];
+        return buffer_info_t {
+            .memory = {},
+            .handle = buffer.buffer,
+            .offset = 0,
+            .size = std::get<transient_buffer_create_info_t>(buffer.info).size,
+            .address = buffer.address,
+        };
+    }
+
+    auto transient_allocator_t::begin_pass(command_buffer_t& command_buffer, uint32 pass) const noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (pass >= _starts.size() || _starts[pass].empty()) {
+            return;
+        }
+        const auto& starts = _starts[pass];
+        const auto is_aliasing = std::any_of(starts.begin(), starts.end(), [this](uint32 index) {
+            return _resources[index].is_aliasing;
+        });
+        auto barriers = barrier_batch_t();
+        // note: the previous occupants must be done writing before the memory is reused
+        if (is_aliasing) {
+            barriers.memory_barrier({
+                .source_stage = pipeline_stage_t::e_all_commands,
+                .dest_stage = pipeline_stage_t::e_all_commands,
+                .source_access = resource_access_t::e_memory_write,
+                .dest_access = resource_access_t::e_memory_read | resource_access_t::e_memory_write,
+            });
+        }
+        for (const auto index : starts) {
+            const auto& resource = _resources[index];
+            if (!resource.image || resource.image->layout() == image_layout_t::e_undefined) {
+                continue;
+            }
+            // note: aliased contents are undefined, the transition discards them
+            barriers.image_barrier({
+                .image = std::cref(*resource.image),
+                .source_stage = pipeline_stage_t::e_all_commands,
+                .dest_stage = pipeline_stage_t::e_all_commands,
+                .source_access = resource_access_t::e_none,
+                .dest_access = resource_access_t::e_memory_read | resource_access_t::e_memory_write,
+                .old_layout = image_layout_t::e_undefined,
+                .new_layout = resource.image->layout(),
+            });
+        }
+        barriers.flush(command_buffer);
+    }
+
+    auto transient_allocator_t::is_compiled() const noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        return _memory != nullptr;
+    }
+
+    auto transient_allocator_t::stats() const noexcept -> transient_allocator_stats_t {
+        IR_PROFILE_SCOPED();
+        return _stats;
+    }
+
+    auto transient_allocator_t::info() const noexcept -> const transient_allocator_create_info_t& {
+        IR_PROFILE_SCOPED();
+        return _info;
+    }
+
+    auto transient_allocator_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    auto transient_allocator_t::_place() noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        // note: linear and optimal resources may end up adjacent, keep them a granularity page apart
+        const auto granularity = static_cast<uint64>(device().properties().limits.bufferImageGranularity);
+        auto order = std::vector<uint32>(_resources.size());
+        std::iota(order.begin(), order.end(), 0_u32);
+        std::sort(order.begin(), order.end(), [this](uint32 a, uint32 b) {
+            return _resources[a].requirements.size > _resources[b].requirements.size;
+        });
+        auto placed = std::vector<uint32>();
+        placed.reserve(order.size());
+        auto ranges = std::vector<std::pair<uint64, uint64>>();
+        auto size = 0_u64;
+        for (const auto index : order) {
+            auto& resource = _resources[index];
+            const auto alignment = std::max(static_cast<uint64>(resource.requirements.alignment), granularity);
+            ranges.clear();
+            for (const auto other : placed) {
+                const auto& neighbour = _resources[other];
+                if (is_overlapping(resource.lifetime, neighbour.lifetime)) {
+                    ranges.emplace_back(neighbour.offset, neighbour.offset + neighbour.requirements.size);
+                }
+            }
+            std::sort(ranges.begin(), ranges.end());
+            // note: first fit below the live ranges, greedy by decreasing size
+            auto offset = 0_u64;
+            for (const auto& [begin, end] : ranges) {
+                if (offset + resource.requirements.size <= begin) {
+                    break;
+                }
+                offset = std::max(offset, align_up(end, alignment));
+            }
+            resource.offset = offset;
+            size = std::max(size, offset + resource.requirements.size);
+            placed.emplace_back(index);
+        }
+        return size;
+    }
+}
@@ -0,0 +1,263 @@
+#include <iris/gfx/device.hpp>
+#include <iris/gfx/semaphore.hpp>
+#include <iris/gfx/upload_ring.hpp>
+
+namespace ir {
+    upload_ring_t::upload_ring_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    upload_ring_t::~upload_ring_t() noexcept {
+        IR_PROFILE_SCOPED();
+        if (!_regions.empty()) {
+            _timeline->wait(_value);
+        }
+        vmaDestroyBuffer(device().allocator(), _handle, _allocation);
+        IR_LOG_INFO(device().logger(), "upload ring {} destroyed", fmt::ptr(_handle));
+    }
+
+    auto upload_ring_t::make(device_t& device, const upload_ring_create_info_t& info) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto ring = arc_ptr<self>(new self(device));
+        auto buffer_info = VkBufferCreateInfo();
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.pNext = nullptr;
+        buffer_info.flags = {};
+        buffer_info.size = info.capacity;
+        buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        if (device.is_supported(device_feature_t::e_buffer_device_address)) {
+            buffer_info.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        }
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        auto allocation_info = VmaAllocationCreateInfo();
+        allocation_info.flags =
+            VMA_ALLOCATION_CREATE_MAPPED_BIT |
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        allocation_info.usage = VMA_MEMORY_USAGE_AUTO;
+        allocation_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        allocation_info.preferredFlags = {};
+        allocation_info.memoryTypeBits = {};
+        allocation_info.pool = {};
+        allocation_info.pUserData = nullptr;
+        allocation_info.priority = 1.0f;
+        IR_VULKAN_CHECK(
+            device.logger(),
+            vmaCreateBuffer(
+                device.allocator(),
+                &buffer_info,
+                &allocation_info,
+                &ring->_handle,
+                &ring->_allocation,
+                &ring->_allocation_info));
+        IR_LOG_INFO(device.logger(), "upload ring {} initialized (capacity: {})", fmt::ptr(ring->_handle), info.capacity);
+        ring->_data = static_cast<uint8*>(ring->_allocation_info.pMappedData);
+        if (device.is_supported(device_feature_t::e_buffer_device_address)) {
+            auto bda_info = VkBufferDeviceAddressInfo();
+            bda_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+            bda_info.pNext = nullptr;
+            bda_info.buffer = ring->_handle;
+            ring->_address = vkGetBufferDeviceAddress(device.handle(), &bda_info);
+        }
+        ring->_timeline = semaphore_t::make(device, {
+            .name = info.name.empty() ? std::string() : info.name + "_timeline",
+            .counter = 0,
+            .timeline = true,
+        });
+        ring->_info = info;
+
+        if (!info.name.empty()) {
+            device.set_debug_name({
+                .type = VK_OBJECT_TYPE_BUFFER,
+                .handle = reinterpret_cast<uint64>(ring->_handle),
+                .name = info.name.c_str()
+            });
+        }
+        return ring;
+    }
+
+    auto upload_ring_t::handle() const noexcept -> VkBuffer {
+        IR_PROFILE_SCOPED();
+        return _handle;
+    }
+
+    auto upload_ring_t::capacity() const noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        return _info.capacity;
+    }
+
+    auto upload_ring_t::timeline() const noexcept -> const semaphore_t& {
+        IR_PROFILE_SCOPED();
+        return *_timeline;
+    }
+
+    auto upload_ring_t::info() const noexcept -> const upload_ring_create_info_t& {
+        IR_PROFILE_SCOPED();
+        return _info;
+    }
+
+    auto upload_ring_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    auto upload_ring_t::allocate(uint64 size, uint64 alignment) noexcept -> upload_allocation_t {
+        IR_PROFILE_SCOPED();
+        size = std::max(size, 1_u64);
+        if (size > _info.spill_threshold || size + alignment > _info.capacity) {
+            return _spill(size);
+        }
+        auto lock = std::unique_lock(_lock);
+        while (true) {
+            _reclaim(_timeline->value());
+            const auto offset = _reserve(size, alignment);
+            if (offset != -1_u64) {
+                return upload_allocation_t {
+                    .slice = {
+                        .memory = _allocation_info.deviceMemory,
+                        .handle = _handle,
+                        .offset = offset,
+                        .size = size,
+                        .address = _address,
+                    },
+                    .data = _data + offset,
+                    .offset = offset,
+                    .spill = {},
+                };
+            }
+            // the oldest slice is still owned by its caller, waiting on it could deadlock
+            const auto& oldest = _regions.front();
+            if (!oldest.is_released) {
+                lock.unlock();
+                IR_LOG_WARN(device().logger(), "upload_ring_t: ring exhausted, spilling {} bytes", size);
+                return _spill(size);
+            }
+            _timeline->wait(oldest.value);
+        }
+    }
+
+    auto upload_ring_t::release(const upload_allocation_t& allocation, uint64 value) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        if (allocation.spill) {
+            const auto destroy = [handle = allocation.slice.handle, spill = allocation.spill](device_t& device) {
+                vmaDestroyBuffer(device.allocator(), handle, spill);
+            };
+            if (value != 0) {
+                device().deletion_queue().push(destroy, *_timeline, value);
+            } else {
+                destroy(device());
+            }
+            return;
+        }
+        auto lock = std::lock_guard(_lock);
+        for (auto& region : _regions) {
+            if (region.offset == allocation.offset && !region.is_released) {
+                region.value = value;
+                region.is_released = true;
+                return;
+            }
+        }
+        IR_ASSERT(false, "upload_ring_t: releasing an unknown allocation");
+    }
+
+    auto upload_ring_t::next_value() noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        return ++_value;
+    }
+
+    auto upload_ring_t::_reclaim(uint64 completed) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        while (!_regions.empty()) {
+            const auto& region = _regions.front();
+            if (!region.is_released || region.value > completed) {
+                break;
+            }
+            _regions.pop_front();
+        }
+        if (_regions.empty()) {
+            _head = 0;
+        }
+    }
+
+    auto upload_ring_t::_reserve(uint64 size, uint64 alignment) noexcept -> uint64 {
+        IR_PROFILE_SCOPED();
+        const auto capacity = _info.capacity;
+        const auto align = [alignment](uint64 offset) {
+            return (offset + alignment - 1) / alignment * alignment;
+        };
+        const auto is_wrapped = !_regions.empty() && _regions.back().offset < _regions.front().offset;
+        const auto tail = _regions.empty() ? capacity : _regions.front().offset;
+        auto offset = align(_head);
+        if (is_wrapped) {
+            if (offset + size > tail) {
+                return -1_u64;
+            }
+        } else if (offset + size > capacity) {
+            // pad the end of the ring and wrap around
+            if (size > tail) {
+                return -1_u64;
+            }
+            if (_head != capacity) {
+                _regions.emplace_back(region_t {
+                    .offset = _head,
+                    .size = capacity - _head,
+                    .value = 0,
+                    .is_released = true,
+                });
+            }
+            offset = 0;
+        }
+        _regions.emplace_back(region_t {
+            .offset = offset,
+            .size = size,
+            .value = 0,
+            .is_released = false,
+        });
+        _head = offset + size;
+        return offset;
+    }
+
+    auto upload_ring_t::_spill(uint64 size) noexcept -> upload_allocation_t {
+        IR_PROFILE_SCOPED();
+        auto buffer_info = VkBufferCreateInfo();
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.pNext = nullptr;
+        buffer_info.flags = {};
+        buffer_info.size = size;
+        buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        auto allocation_info = VmaAllocationCreateInfo();
+        allocation_info.flags =
+            VMA_ALLOCATION_CREATE_MAPPED_BIT |
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        allocation_info.usage = VMA_MEMORY_USAGE_AUTO;
+        allocation_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        auto handle = VkBuffer();
+        auto allocation = VmaAllocation();
+        auto allocation_extra_info = VmaAllocationInfo();
+        IR_VULKAN_CHECK(
+            device().logger(),
+            vmaCreateBuffer(
+                device().allocator(),
+                &buffer_info,
+                &allocation_info,
+                &handle,
+                &allocation,
+                &allocation_extra_info));
+        return upload_allocation_t {
+            .slice = {
+                .memory = allocation_extra_info.deviceMemory,
+                .handle = handle,
+                .offset = 0,
+                .size = size,
+                .address = 0,
+            },
+            .data = static_cast<uint8*>(allocation_extra_info.pMappedData),
+            .offset = -1_u64,
+            .spill = allocation,
+        };
+    }
+}
@@ -0,0 +1,292 @@
+#include <iris/gfx/device.hpp>
+#include <iris/gfx/command_pool.hpp>
+#include <iris/gfx/command_buffer.hpp>
+#include <iris/gfx/semaphore.hpp>
+#include <iris/gfx/upload_service.hpp>
+
+namespace ir {
+    upload_service_t::upload_service_t(device_t& device) noexcept
+        : _device(std::ref(device)) {
+        IR_PROFILE_SCOPED();
+    }
+
+    upload_service_t::~upload_service_t() noexcept {
+        IR_PROFILE_SCOPED();
+        flush();
+        timeline().wait(_submitted);
+        _in_flight.clear();
+        _recycled.clear();
+        _acquires.clear();
+    }
+
+    auto upload_service_t::make(device_t& device) noexcept -> arc_ptr<self> {
+        IR_PROFILE_SCOPED();
+        auto service = arc_ptr<self>(new self(device));
+        service->_pool = command_pool_t::make(device, {
+            .name = "upload_command_pool",
+            .queue = queue_type_t::e_transfer,
+            .flags = command_pool_flag_t::e_transient | command_pool_flag_t::e_reset_command_buffer,
+        });
+        return service;
+    }
+
+    auto upload_service_t::timeline() const noexcept -> const semaphore_t& {
+        IR_PROFILE_SCOPED();
+        return device().upload_ring().timeline();
+    }
+
+    auto upload_service_t::device() const noexcept -> device_t& {
+        IR_PROFILE_SCOPED();
+        return _device.get();
+    }
+
+    auto upload_service_t::upload(const upload_buffer_info_t& info) noexcept -> upload_handle_t {
+        IR_PROFILE_SCOPED();
+        auto& ring = device().upload_ring();
+        auto staging = ring.allocate(info.data.size_bytes());
+        std::memcpy(staging.data, info.data.data(), info.data.size_bytes());
+
+        auto lock = std::lock_guard(_lock);
+        auto& batch = _open();
+        auto& command_buffer = *batch.command_buffer;
+        command_buffer.copy_buffer(staging.slice, info.dest, {});
+        const auto source_family = device().transfer_queue().family();
+        const auto dest_family = _family(info.queue);
+        if (!info.is_shared && source_family != dest_family) {
+            command_buffer.buffer_barrier({
+                .buffer = info.dest,
+                .source_stage = pipeline_stage_t::e_transfer,
+                .dest_stage = pipeline_stage_t::e_none,
+                .source_access = resource_access_t::e_transfer_write,
+                .dest_access = resource_access_t::e_none,
+                .source_family = source_family,
+                .dest_family = dest_family,
+            });
+            batch.acquires.emplace_back(pending_acquire_t {
+                .image = {},
+                .buffer = info.dest,
+                .layout = image_layout_t::e_undefined,
+                .family = dest_family,
+            });
+        }
+        batch.size += staging.slice.size;
+        batch.staging.emplace_back(std::move(staging));
+        const auto handle = upload_handle_t { batch.value };
+        if (batch.size >= max_batch_size) {
+            _submit();
+        }
+        return handle;
+    }
+
+    auto upload_service_t::upload(const upload_image_info_t& info) noexcept -> upload_handle_t {
+        IR_PROFILE_SCOPED();
+        const auto& image = info.image.get();
+        auto& ring = device().upload_ring();
+        auto staging = ring.allocate(info.data.size_bytes());
+        std::memcpy(staging.data, info.data.data(), info.data.size_bytes());
+
+        auto lock = std::lock_guard(_lock);
+        auto& batch = _open();
+        auto& command_buffer = *batch.command_buffer;
+        command_buffer.image_barrier({
+            .image = image,
+            .source_stage = pipeline_stage_t::e_none,
+            .dest_stage = pipeline_stage_t::e_transfer,
+            .source_access = resource_access_t::e_none,
+            .dest_access = resource_access_t::e_transfer_write,
+            .old_layout = image_layout_t::e_undefined,
+            .new_layout = image_layout_t::e_transfer_dst_optimal,
+        });
+        for (const auto& region : info.regions) {
+            auto source = staging.slice;
+            source.offset += region.offset;
+            source.size -= region.offset;
+            command_buffer.copy_buffer_to_image(source, image, region.subresource);
+        }
+        const auto source_family = device().transfer_queue().family();
+        const auto dest_family = _family(image.info().queue);
+        if (source_family != dest_family) {
+            // note: release half of the ownership transfer, the layout transition happens once
+            command_buffer.image_barrier({
+                .image = image,
+                .source_stage = pipeline_stage_t::e_transfer,
+                .dest_stage = pipeline_stage_t::e_none,
+                .source_access = resource_access_t::e_transfer_write,
+                .dest_access = resource_access_t::e_none,
+                .old_layout = image_layout_t::e_transfer_dst_optimal,
+                .new_layout = info.layout,
+                .source_family = source_family,
+                .dest_family = dest_family,
+            });
+            batch.acquires.emplace_back(pending_acquire_t {
+                .image = image.as_intrusive_ptr(),
+                .buffer = {},
+                .layout = info.layout,
+                .family = dest_family,
+            });
+        } else {
+            command_buffer.image_barrier({
+                .image = image,
+                .source_stage = pipeline_stage_t::e_transfer,
+                .dest_stage = pipeline_stage_t::e_all_commands,
+                .source_access = resource_access_t::e_transfer_write,
+                .dest_access = resource_access_t::e_memory_read,
+                .old_layout = image_layout_t::e_transfer_dst_optimal,
+                .new_layout = info.layout,
+            });
+        }
+        batch.size += staging.slice.size;
+        batch.staging.emplace_back(std::move(staging));
+        const auto handle = upload_handle_t { batch.value };
+        if (batch.size >= max_batch_size) {
+            _submit();
+        }
+        return handle;
+    }
+
+    auto upload_service_t::flush() noexcept -> upload_handle_t {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        if (_batch) {
+            _submit();
+        }
+        return { _submitted };
+    }
+
+    auto upload_service_t::acquire(
+        command_buffer_t& command_buffer,
+        pipeline_stage_t stage
+    ) noexcept -> std::optional<queue_semaphore_stage_t> {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        if (_batch) {
+            _submit();
+        }
+        const auto family = _family(command_buffer.pool().info().queue);
+        auto& acquired = _acquired[family];
+        if (acquired == _submitted) {
+            return std::nullopt;
+        }
+        const auto source_family = device().transfer_queue().family();
+        auto barriers = barrier_batch_t();
+        std::erase_if(_acquires, [&](const auto& acquire) {
+            if (acquire.family != family) {
+                return false;
+            }
+            if (acquire.image) {
+                barriers.image_barrier({
+                    .image = *acquire.image,
+                    .source_stage = pipeline_stage_t::e_none,
+                    .dest_stage = stage,
+                    .source_access = resource_access_t::e_none,
+                    .dest_access = resource_access_t::e_memory_read,
+                    .old_layout = image_layout_t::e_transfer_dst_optimal,
+                    .new_layout = acquire.layout,
+                    .source_family = source_family,
+                    .dest_family = family,
+                });
+            } else {
+                barriers.buffer_barrier({
+                    .buffer = acquire.buffer,
+                    .source_stage = pipeline_stage_t::e_none,
+                    .dest_stage = stage,
+                    .source_access = resource_access_t::e_none,
+                    .dest_access = resource_access_t::e_memory_read,
+                    .source_family = source_family,
+                    .dest_family = family,
+                });
+            }
+            return true;
+        });
+        barriers.flush(command_buffer);
+        acquired = _submitted;
+        return queue_semaphore_stage_t {
+            .semaphore = std::cref(timeline()),
+            .stage = stage,
+            .value = _submitted,
+        };
+    }
+
+    auto upload_service_t::is_complete(upload_handle_t handle) const noexcept -> bool {
+        IR_PROFILE_SCOPED();
+        return timeline().value() >= handle.value;
+    }
+
+    auto upload_service_t::wait(upload_handle_t handle) noexcept -> void {
+        IR_PROFILE_SCOPED();
+        {
+            auto lock = std::lock_guard(_lock);
+            if (_batch && _batch->value <= handle.value) {
+                _submit();
+            }
+        }
+        timeline().wait(handle.value);
+    }
+
+    auto upload_service_t::tick() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto lock = std::lock_guard(_lock);
+        if (_batch) {
+            _submit();
+        }
+        const auto completed = timeline().value();
+        while (!_in_flight.empty() && _in_flight.front().value <= completed) {
+            _recycled.emplace_back(std::move(_in_flight.front().command_buffer));
+            _in_flight.pop_front();
+        }
+    }
+
+    auto upload_service_t::_open() noexcept -> batch_t& {
+        IR_PROFILE_SCOPED();
+        if (!_batch) {
+            // note: values are reserved in submission order, the service is the only signaler
+            auto& batch = _batch.emplace();
+            if (!_recycled.empty()) {
+                batch.command_buffer = std::move(_recycled.back());
+                _recycled.pop_back();
+            } else {
+                batch.command_buffer = command_buffer_t::make(*_pool, {});
+            }
+            batch.command_buffer->begin();
+            batch.value = device().upload_ring().next_value();
+        }
+        return *_batch;
+    }
+
+    auto upload_service_t::_submit() noexcept -> void {
+        IR_PROFILE_SCOPED();
+        auto batch = std::move(*_batch);
+        _batch.reset();
+        batch.command_buffer->end();
+        device().transfer_queue().submit({
+            .command_buffers = { std::cref(*batch.command_buffer) },
+            .wait_semaphores = {},
+            .signal_semaphores = {
+                queue_semaphore_stage_t {
+                    .semaphore = std::cref(timeline()),
+                    .stage = pipeline_stage_t::e_all_commands,
+                    .value = batch.value,
+                },
+            },
+        });
+        auto& ring = device().upload_ring();
+        for (const auto& staging : batch.staging) {
+            ring.release(staging, batch.value);
+        }
+        batch.staging.clear();
+        _acquires.insert(_acquires.end(), batch.acquires.begin(), batch.acquires.end());
+        batch.acquires.clear();
+        _submitted = batch.value;
+        _in_flight.emplace_back(std::move(batch));
+    }
+
+    auto upload_service_t::_family(queue_type_t type) const noexcept -> uint32 {
+        IR_PROFILE_SCOPED();
+        switch (type) {
+            case queue_type_t::e_graphics: return device().graphics_queue().family();
+            case queue_type_t::e_compute: return device().compute_queue().family();
+            case queue_type_t::e_transfer: return device().transfer_queue().family();
+        }
+        IR_UNREACHABLE();
+    }
+}